@@ -1,4 +1,5 @@
 import { runBenchmark, hypernode } from "./utils.js";
+import { SharedCPool } from "../dist/http/context/SharedCPool.js";
 
 const { CPool } = hypernode;
 
@@ -33,3 +34,34 @@ runBenchmark(
   },
   100_000
 );
+
+// --- shared state: allocate/free in JS, no native call
+// Uses the compiled SharedCPool, run `npm run build-ts` first.
+const shared = new SharedCPool(new CPool());
+shared.initializePool(1024);
+for (let i = 0; i < 1024; i++) {
+  const obj = { id: -1 };
+  obj.id = shared.registerObj(obj);
+}
+
+runBenchmark(
+  "CPool shared allocate (hot)",
+  () => {
+    const obj = shared.allocate();
+    if (obj !== null) shared.free(obj.id);
+  },
+  500_000
+);
+
+runBenchmark(
+  "CPool shared allocate burst 16",
+  () => {
+    const idxs = [];
+    for (let i = 0; i < 16; i++) {
+      const obj = shared.allocate();
+      if (obj !== null) idxs.push(obj.id);
+    }
+    for (const id of idxs) shared.free(id);
+  },
+  100_000
+);
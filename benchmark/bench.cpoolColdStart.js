@@ -0,0 +1,35 @@
+import { hypernode, nowNs, diffNs } from "./utils.js";
+
+const { CPool } = hypernode;
+
+// Pool registration at server start (HttpContext.initRuntime): one object
+// per slot, maxRequests slots. Each size runs once on a fresh pool.
+const SIZES = [5_000, 50_000, 200_000];
+
+function makeObjs(n) {
+  const objs = new Array(n);
+  for (let i = 0; i < n; i++) objs[i] = { id: i };
+  return objs;
+}
+
+function coldStart(name, n, register) {
+  const pool = new CPool();
+  pool.initializePool(n);
+  const objs = makeObjs(n);
+
+  const start = nowNs();
+  register(pool, objs);
+  const ms = diffNs(start, nowNs()) / 1e6;
+
+  console.log(`${name} (${n.toLocaleString()} slots): ${ms.toFixed(2)} ms`);
+}
+
+for (const n of SIZES) {
+  coldStart("CPool registerObj loop", n, (pool, objs) => {
+    for (let i = 0; i < objs.length; i++) pool.registerObj(objs[i]);
+  });
+
+  coldStart("CPool registerMany", n, (pool, objs) => {
+    pool.registerMany(objs);
+  });
+}
@@ -1,12 +1,10 @@
 import { runBenchmark, hypernode } from "./utils.js";
 
-const {
-  registerRoutes,
-  scannerRouteFirst
-} = hypernode;
+const { HttpCore } = hypernode;
 
+const MAX_HEADER_NAME_SIZE = 4 * 1024;
+const MAX_HEADER_VALUE_SIZE = 4 * 1024;
 const MAX_HEADER_SIZE = 8 * 1024;
-const MAX_CONTENT_LENGTH = 1024 * 1024;
 const QUERY_LIMIT = 10;
 
 // --- routes
@@ -14,17 +12,35 @@ const routes = [];
 for (let i = 0; i < 50; i++) {
   routes.push({
     method: "GET",
-    url: `/route${i}`,
+    route: `/route${i}`,
     vptrTableIndex: i
   });
 }
-registerRoutes(routes);
+for (let i = 0; i < 50; i++) {
+  routes.push({
+    method: "GET",
+    route: `/api/v1/resource${i}/details/settings`,
+    vptrTableIndex: 50 + i
+  });
+}
+
+// Static (method, path) hash in front of the trie (default)
+const hashCore = new HttpCore();
+hashCore.registerRoutes(routes);
+
+// Trie only
+const trieCore = new HttpCore();
+trieCore.registerRoutes(routes, { staticRouteHash: false });
 
 // --- buffers
 const existsBuf = Buffer.from(
   "GET /route25 HTTP/1.1\r\nHost: a\r\n\r\n"
 );
 
+const longExistsBuf = Buffer.from(
+  "GET /api/v1/resource37/details/settings HTTP/1.1\r\nHost: a\r\n\r\n"
+);
+
 const notExistsBuf = Buffer.from(
   "GET /not-found HTTP/1.1\r\nHost: a\r\n\r\n"
 );
@@ -41,33 +57,30 @@ function freshReq() {
   };
 }
 
+function bench(name, core, buf) {
+  runBenchmark(
+    name,
+    () => {
+      const req = freshReq();
+      core.scannerRouteFirst(
+        buf,
+        req,
+        MAX_HEADER_NAME_SIZE,
+        MAX_HEADER_VALUE_SIZE,
+        MAX_HEADER_SIZE,
+        QUERY_LIMIT
+      );
+    },
+    200_000
+  );
+}
+
 // --- benchmarks
-runBenchmark(
-  "scannerRouteFirst (route exists)",
-  () => {
-    const req = freshReq();
-    scannerRouteFirst(
-      existsBuf,
-      req,
-      MAX_HEADER_SIZE,
-      MAX_CONTENT_LENGTH,
-      QUERY_LIMIT
-    );
-  },
-  200_000
-);
+bench("scannerRouteFirst trie (route exists)", trieCore, existsBuf);
+bench("scannerRouteFirst hash (route exists)", hashCore, existsBuf);
 
-runBenchmark(
-  "scannerRouteFirst (route NOT exists)",
-  () => {
-    const req = freshReq();
-    scannerRouteFirst(
-      notExistsBuf,
-      req,
-      MAX_HEADER_SIZE,
-      MAX_CONTENT_LENGTH,
-      QUERY_LIMIT
-    );
-  },
-  200_000
-);
+bench("scannerRouteFirst trie (long route exists)", trieCore, longExistsBuf);
+bench("scannerRouteFirst hash (long route exists)", hashCore, longExistsBuf);
+
+bench("scannerRouteFirst trie (route NOT exists)", trieCore, notExistsBuf);
+bench("scannerRouteFirst hash (route NOT exists)", hashCore, notExistsBuf);
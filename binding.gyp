@@ -2,6 +2,9 @@
   "targets": [
     {
       "target_name": "hypernode",
+      "variables": {
+        "alloc_stats%": 0
+      },
       "sources": [
         "native/main.cpp",
         "<!@(node -p \"require('fs').readdirSync('native/http/core').filter(f => f.endsWith('.cpp')).map(f => 'native/http/core/' + f).join(' ')\")",
@@ -24,6 +27,11 @@
         "NAPI_VERSION=8",
         "NAPI_CPP_EXCEPTIONS"
       ],
+      "conditions": [
+        ["alloc_stats==1", {
+          "defines": [ "HYPERNODE_ALLOC_STATS" ]
+        }]
+      ],
       "cflags_cc": [
         "-std=gnu++17",
         "-fexceptions"
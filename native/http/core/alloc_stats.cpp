@@ -0,0 +1,36 @@
+#include "alloc_stats.h"
+
+#ifdef HYPERNODE_ALLOC_STATS
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t t_allocs = 0;
+
+uint64_t allocCount() noexcept {
+    return t_allocs;
+}
+
+void* operator new(std::size_t n) {
+    ++t_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n) {
+    return ::operator new(n);
+}
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    ++t_allocs;
+    return std::malloc(n ? n : 1);
+}
+
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    return ::operator new(n, std::nothrow);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
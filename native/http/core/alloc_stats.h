@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+
+/// Heap allocation counter for the malloc-counting tests.
+///
+/// Only compiled in with HYPERNODE_ALLOC_STATS (node-gyp rebuild --
+/// -Dalloc_stats=1), which replaces the global operator new/delete of the
+/// addon. The count is per thread, so it only reflects allocations made on
+/// the JS thread.
+#ifdef HYPERNODE_ALLOC_STATS
+uint64_t allocCount() noexcept;
+#endif
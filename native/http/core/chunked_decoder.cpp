@@ -0,0 +1,271 @@
+#include "chunked_decoder.h"
+#include "simd.h"
+#include <cstring>
+
+namespace {
+
+using namespace ChunkedDecoding;
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// tchar (RFC 9110 §5.6.2), the only bytes allowed in a trailer field name.
+struct TokenTable {
+    bool v[256] = {};
+    TokenTable() {
+        for (int c = '0'; c <= '9'; ++c) v[c] = true;
+        for (int c = 'a'; c <= 'z'; ++c) v[c] = true;
+        for (int c = 'A'; c <= 'Z'; ++c) v[c] = true;
+        for (const char* s = "!#$%&'*+-.^_`|~"; *s; ++s) v[(uint8_t)*s] = true;
+    }
+};
+
+const TokenTable tokenTable;
+
+// Extension and trailer value bytes: anything but CTLs (HTAB allowed) and DEL.
+inline bool isValueByte(uint8_t c) {
+    return (c >= 32 || c == '\t') && c != 127;
+}
+
+inline bool validValueRun(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        if (!isValueByte((uint8_t)*p)) return false;
+    }
+    return true;
+}
+
+}
+
+namespace ChunkedDecoding {
+
+void Decoder::reset(uint64_t maxContentSize) {
+    m_state = ST_SIZE;
+    m_error = CHUNKED_MORE;
+    m_digits = 0;
+    m_hasName = false;
+    m_remaining = 0;
+    m_written = 0;
+    m_maxContentSize = maxContentSize;
+    m_extBytes = 0;
+    m_trailerBytes = 0;
+}
+
+Status Decoder::decode(const char* in, size_t n, char* dest, size_t destCap, size_t* consumed) {
+    const char* p = in;
+    const char* const end = in + n;
+
+    auto fail = [&](Status s) {
+        m_state = ST_ERROR;
+        m_error = s;
+        *consumed = (size_t)(p - in);
+        return s;
+    };
+
+    if (m_state == ST_ERROR) [[unlikely]] {
+        *consumed = 0;
+        return m_error;
+    }
+
+    while (p < end && m_state != ST_DONE) {
+        switch (m_state) {
+        case ST_SIZE: {
+            int v = hexValue(*p);
+            if (v >= 0) {
+                if (++m_digits > 16) return fail(CHUNKED_ERR_SIZE);
+                m_remaining = (m_remaining << 4) | (uint64_t)v;
+                ++p;
+                break;
+            }
+            if (m_digits == 0) return fail(CHUNKED_ERR_SIZE);
+            if (*p == '\r') {
+                m_state = ST_SIZE_LF;
+                ++p;
+                break;
+            }
+            if (*p == ';' || *p == ' ' || *p == '\t') {
+                m_state = ST_EXT_BWS;
+                break;
+            }
+            return fail(*p == '\n' ? CHUNKED_ERR_CRLF : CHUNKED_ERR_SIZE);
+        }
+
+        // chunk-ext = *( BWS ";" BWS chunk-ext-name [ BWS "=" BWS chunk-ext-val ] )
+        // Only the leading ";" is checked structurally, the rest must be
+        // visible bytes up to CRLF and is ignored.
+        case ST_EXT_BWS:
+            if (++m_extBytes > MAX_EXTENSION_BYTES) return fail(CHUNKED_ERR_EXTENSION);
+            if (*p == ';') m_state = ST_EXT;
+            else if (*p != ' ' && *p != '\t') return fail(CHUNKED_ERR_EXTENSION);
+            ++p;
+            break;
+
+        case ST_EXT: {
+            const char* q = simd_find_any<'\r', '\n'>(p, end);
+            m_extBytes += (uint32_t)(q - p);
+            if (m_extBytes > MAX_EXTENSION_BYTES || !validValueRun(p, q)) return fail(CHUNKED_ERR_EXTENSION);
+            p = q;
+            if (p == end) break;
+            if (*p == '\n') return fail(CHUNKED_ERR_CRLF);
+            m_state = ST_SIZE_LF;
+            ++p;
+            break;
+        }
+
+        case ST_SIZE_LF:
+            if (*p != '\n') return fail(CHUNKED_ERR_CRLF);
+            ++p;
+            m_digits = 0;
+            if (m_remaining == 0) {
+                m_state = ST_TRAILER_START;
+                break;
+            }
+            if (m_remaining > m_maxContentSize - m_written) return fail(CHUNKED_ERR_TOO_LARGE);
+            m_state = ST_DATA;
+            break;
+
+        case ST_DATA: {
+            size_t room = destCap > m_written ? destCap - (size_t)m_written : 0;
+            if (room == 0) {
+                *consumed = (size_t)(p - in);
+                return CHUNKED_DEST_FULL;
+            }
+            size_t take = (size_t)(end - p);
+            if (take > m_remaining) take = (size_t)m_remaining;
+            if (take > room) take = room;
+
+            memcpy(dest + m_written, p, take);
+            m_written += take;
+            m_remaining -= take;
+            p += take;
+            if (m_remaining == 0) m_state = ST_DATA_CR;
+            break;
+        }
+
+        case ST_DATA_CR:
+            if (*p != '\r') return fail(CHUNKED_ERR_CRLF);
+            m_state = ST_DATA_LF;
+            ++p;
+            break;
+
+        case ST_DATA_LF:
+            if (*p != '\n') return fail(CHUNKED_ERR_CRLF);
+            m_state = ST_SIZE;
+            ++p;
+            break;
+
+        // trailer-section = *( field-line CRLF ), then the final CRLF.
+        case ST_TRAILER_START:
+            if (*p == '\r') {
+                m_state = ST_FINAL_LF;
+                ++p;
+                break;
+            }
+            // obs-fold is not allowed in trailers either.
+            if (*p == ' ' || *p == '\t') return fail(CHUNKED_ERR_TRAILER);
+            if (*p == '\n') return fail(CHUNKED_ERR_CRLF);
+            m_hasName = false;
+            m_state = ST_TRAILER_NAME;
+            break;
+
+        case ST_TRAILER_NAME:
+            if (++m_trailerBytes > MAX_TRAILER_BYTES) return fail(CHUNKED_ERR_TRAILER);
+            if (*p == ':') {
+                if (!m_hasName) return fail(CHUNKED_ERR_TRAILER);
+                m_state = ST_TRAILER_VALUE;
+            } else if (tokenTable.v[(uint8_t)*p]) {
+                m_hasName = true;
+            } else {
+                return fail(CHUNKED_ERR_TRAILER);
+            }
+            ++p;
+            break;
+
+        case ST_TRAILER_VALUE: {
+            const char* q = simd_find_any<'\r', '\n'>(p, end);
+            m_trailerBytes += (uint32_t)(q - p);
+            if (m_trailerBytes > MAX_TRAILER_BYTES || !validValueRun(p, q)) return fail(CHUNKED_ERR_TRAILER);
+            p = q;
+            if (p == end) break;
+            if (*p == '\n') return fail(CHUNKED_ERR_CRLF);
+            m_state = ST_TRAILER_LF;
+            ++p;
+            break;
+        }
+
+        case ST_TRAILER_LF:
+            if (*p != '\n') return fail(CHUNKED_ERR_CRLF);
+            m_state = ST_TRAILER_START;
+            ++p;
+            break;
+
+        case ST_FINAL_LF:
+            if (*p != '\n') return fail(CHUNKED_ERR_CRLF);
+            m_state = ST_DONE;
+            ++p;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    *consumed = (size_t)(p - in);
+    return m_state == ST_DONE ? CHUNKED_DONE : CHUNKED_MORE;
+}
+
+}
+
+Napi::Function ChunkedDecoder::GetClass(Napi::Env env) {
+    return DefineClass(env, "ChunkedDecoder", {
+        InstanceMethod("reset", &ChunkedDecoder::Reset),
+        InstanceMethod("write", &ChunkedDecoder::Write),
+        InstanceMethod("length", &ChunkedDecoder::Length),
+        InstanceMethod("consumed", &ChunkedDecoder::Consumed),
+    });
+}
+
+ChunkedDecoder::ChunkedDecoder(const Napi::CallbackInfo& info)
+: Napi::ObjectWrap<ChunkedDecoder>(info) {
+    decoder.reset(0);
+}
+
+Napi::Value ChunkedDecoder::Reset(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber()) [[unlikely]] {
+        Napi::TypeError::New(env, "Expected (maxContentSize: number)").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    int64_t max = info[0].As<Napi::Number>().Int64Value();
+    decoder.reset(max > 0 ? (uint64_t)max : 0);
+    lastConsumed = 0;
+    return env.Undefined();
+}
+
+Napi::Value ChunkedDecoder::Write(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) [[unlikely]] {
+        Napi::TypeError::New(env, "Expected (chunk: Buffer, dest: Buffer)").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto chunk = info[0].As<Napi::Buffer<char>>();
+    auto dest = info[1].As<Napi::Buffer<char>>();
+
+    ChunkedDecoding::Status s = decoder.decode(chunk.Data(), chunk.Length(), dest.Data(), dest.Length(), &lastConsumed);
+    return Napi::Number::New(env, s);
+}
+
+Napi::Value ChunkedDecoder::Length(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), (double)decoder.length());
+}
+
+Napi::Value ChunkedDecoder::Consumed(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), (double)lastConsumed);
+}
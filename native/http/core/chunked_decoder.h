@@ -0,0 +1,93 @@
+#pragma once
+#include <napi.h>
+#include <cstdint>
+#include <cstddef>
+
+/// Resumable decoder for Transfer-Encoding: chunked (RFC 9112 §7.1).
+///
+/// Chunk data is copied straight behind what was already decoded in one
+/// caller-owned destination buffer, so the finished body needs no concat.
+/// The size line, chunk extensions and trailer section are validated on the
+/// way: bare LF, obs-fold, oversized sizes/extensions/trailers and malformed
+/// trailer lines are rejected. Trailer fields are discarded, never merged
+/// into the header section.
+namespace ChunkedDecoding {
+
+    /// Results of Decoder::decode. Must stay in the same order as
+    /// ChunkedStatus in ts/http/chunker/NativeChunkedParser.ts.
+    enum Status : int32_t {
+        CHUNKED_MORE = 0,        // input consumed, body not complete
+        CHUNKED_DONE = 1,        // last-chunk and trailer section read
+        CHUNKED_DEST_FULL = 2,   // destination full, grow it and call again with the rest
+        CHUNKED_ERR_SIZE = -1,   // missing, non-hex or more than 16 digit chunk size
+        CHUNKED_ERR_TOO_LARGE = -2,
+        CHUNKED_ERR_EXTENSION = -3,
+        CHUNKED_ERR_TRAILER = -4,
+        CHUNKED_ERR_CRLF = -5    // bare LF or missing CRLF after a line / chunk data
+    };
+
+    /// Chunk extensions of one message may not exceed this many bytes.
+    constexpr uint32_t MAX_EXTENSION_BYTES = 4096;
+    /// Trailer section of one message may not exceed this many bytes.
+    constexpr uint32_t MAX_TRAILER_BYTES = 8192;
+
+    class Decoder {
+    public:
+        void reset(uint64_t maxContentSize);
+
+        /// Decodes in[0, n) into dest behind the bytes already written.
+        /// *consumed is set to the number of input bytes used; on
+        /// CHUNKED_DONE the remaining input belongs to the next request.
+        Status decode(const char* in, size_t n, char* dest, size_t destCap, size_t* consumed);
+
+        /// Body bytes written to the destination so far.
+        uint64_t length() const { return m_written; }
+
+    private:
+        enum State : uint8_t {
+            ST_SIZE,
+            ST_EXT_BWS,
+            ST_EXT,
+            ST_SIZE_LF,
+            ST_DATA,
+            ST_DATA_CR,
+            ST_DATA_LF,
+            ST_TRAILER_START,
+            ST_TRAILER_NAME,
+            ST_TRAILER_VALUE,
+            ST_TRAILER_LF,
+            ST_FINAL_LF,
+            ST_DONE,
+            ST_ERROR
+        };
+
+        State m_state = ST_SIZE;
+        Status m_error = CHUNKED_MORE;
+        uint8_t m_digits = 0;
+        bool m_hasName = false;
+        uint64_t m_remaining = 0;
+        uint64_t m_written = 0;
+        uint64_t m_maxContentSize = 0;
+        uint32_t m_extBytes = 0;
+        uint32_t m_trailerBytes = 0;
+    };
+}
+
+/// JS wrapper: reset(maxContentSize), write(chunk, dest) -> status,
+/// length(), consumed().
+class ChunkedDecoder : public Napi::ObjectWrap<ChunkedDecoder> {
+public:
+    static Napi::Function GetClass(Napi::Env env);
+
+    ChunkedDecoder(const Napi::CallbackInfo& info);
+    ~ChunkedDecoder() = default;
+
+    Napi::Value Reset(const Napi::CallbackInfo& info);
+    Napi::Value Write(const Napi::CallbackInfo& info);
+    Napi::Value Length(const Napi::CallbackInfo& info);
+    Napi::Value Consumed(const Napi::CallbackInfo& info);
+
+private:
+    ChunkedDecoding::Decoder decoder;
+    size_t lastConsumed = 0;
+};
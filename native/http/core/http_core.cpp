@@ -101,6 +101,98 @@ static inline MethodType scanHttpMethod(const char* curl, uint32_t* offset) {
     return M_ERROR;
 }
 
+// Scans the header block either into the `headers` object of reqObj or, when
+// a Uint32Array is supplied at info[spanArg], into that span table.
+static FlagBits scanHeaderBlock(
+    const Napi::CallbackInfo& info, size_t spanArg, Napi::Object& reqObj,
+    const char* curl, size_t curlLen, uint32_t* offset, bool resume,
+    uint32_t maxHeaderSize, uint32_t maxHeaderNameSize, uint32_t maxHeaderValueSize,
+    uint32_t currentHeaderSize, MethodType method,
+    HttpScanner::HeaderScanState* resumeState, ScratchArena* scratch
+) {
+    if (info.Length() > spanArg && info[spanArg].IsTypedArray()) {
+        auto spans = info[spanArg].As<Napi::Uint32Array>();
+        if (spans.ElementLength() <= HttpScanner::HEADER_SPAN_HEAD) [[unlikely]]
+            return FLAG_INVALID_ARGUMENT;
+
+        if (!resume) spans[HttpScanner::HEADER_SPAN_COUNT_SLOT] = 0;
+
+        HttpScanner::SpanHeaderSink sink(spans.Data(), spans.ElementLength());
+        return scanHeaders(curl, curlLen, offset,
+                           maxHeaderSize, maxHeaderNameSize, maxHeaderValueSize,
+                           currentHeaderSize, method, sink, resumeState);
+    }
+
+    Napi::Object headers = reqObj.Get("headers").As<Napi::Object>();
+    HttpScanner::ObjectHeaderSink sink(info.Env(), &headers, scratch);
+    return scanHeaders(curl, curlLen, offset,
+                       maxHeaderSize, maxHeaderNameSize, maxHeaderValueSize,
+                       currentHeaderSize, method, sink, resumeState);
+}
+
+// Scalar results of a scan. Written into the Int32Array slot bank at
+// info[slotArg] when present, otherwise as properties of reqObj.
+class ScanResult {
+public:
+    ScanResult(const Napi::CallbackInfo& info, size_t slotArg, Napi::Object& reqObj)
+        : m_env(info.Env()), m_reqObj(reqObj), m_slots(nullptr) {
+        if (info.Length() > slotArg && info[slotArg].IsTypedArray()) {
+            auto slots = info[slotArg].As<Napi::Int32Array>();
+            if (slots.ElementLength() >= RS_RESUME_STATE) m_slots = slots.Data();
+            m_canResume = slots.ElementLength() >= RS_COUNT;
+        }
+    }
+
+    bool hasSlots() const { return m_slots != nullptr; }
+
+    // Header scan progress carried between scannerHeader calls, nullptr
+    // when the slot bank has no room for it.
+    HttpScanner::HeaderScanState* resume() {
+        if (!m_canResume) return nullptr;
+        m_resume.state      = (uint32_t)m_slots[RS_RESUME_STATE];
+        m_resume.header     = (uint32_t)m_slots[RS_RESUME_HEADER];
+        m_resume.nameStart  = (uint32_t)m_slots[RS_RESUME_NAME_START];
+        m_resume.nameLen    = (uint32_t)m_slots[RS_RESUME_NAME_LEN];
+        m_resume.valueStart = (uint32_t)m_slots[RS_RESUME_VALUE_START];
+        m_resume.scanPos    = (uint32_t)m_slots[RS_RESUME_SCAN_POS];
+        return &m_resume;
+    }
+
+    void storeResume() {
+        if (!m_canResume) return;
+        m_slots[RS_RESUME_STATE]       = (int32_t)m_resume.state;
+        m_slots[RS_RESUME_HEADER]      = (int32_t)m_resume.header;
+        m_slots[RS_RESUME_NAME_START]  = (int32_t)m_resume.nameStart;
+        m_slots[RS_RESUME_NAME_LEN]    = (int32_t)m_resume.nameLen;
+        m_slots[RS_RESUME_VALUE_START] = (int32_t)m_resume.valueStart;
+        m_slots[RS_RESUME_SCAN_POS]    = (int32_t)m_resume.scanPos;
+    }
+
+    int32_t get(ResultSlot slot) const {
+        if (m_slots) return m_slots[slot];
+        return m_reqObj.Get(NAMES[slot]).As<Napi::Number>().Int32Value();
+    }
+
+    void set(ResultSlot slot, int32_t value) {
+        if (m_slots) {
+            m_slots[slot] = value;
+            return;
+        }
+        m_reqObj.Set(NAMES[slot], Napi::Number::New(m_env, value));
+    }
+
+private:
+    static constexpr const char* NAMES[RS_RESUME_STATE] = {
+        "method", "retFlag", "mainOffset", "headerSize", "queryStart", "queryLen"
+    };
+
+    Napi::Env m_env;
+    Napi::Object& m_reqObj;
+    int32_t* m_slots;
+    bool m_canResume = false;
+    HttpScanner::HeaderScanState m_resume{};
+};
+
 Napi::Function HttpCore::GetClass(Napi::Env env) {
     return DefineClass(env, "HttpCore", {
         InstanceMethod("registerRoutes", &HttpCore::RegisterRoutes),
@@ -123,7 +215,8 @@ RouteBuilder::EndpointParam HttpCore::makeParam(const std::string& name, RouteBu
     return RouteBuilder::EndpointParam{ name, type };
 }
 
-RouteBuilder::Endpoint HttpCore::makeEndpoint(const std::string& url, int vptr_table_index) {
+RouteBuilder::Endpoint HttpCore::makeEndpoint(const std::string& url, int vptr_table_index,
+                                              const std::vector<RouteBuilder::ParamType>& paramTypes) {
     RouteBuilder::Endpoint ep{};
     std::string out;
     std::vector<RouteBuilder::EndpointParam> params;
@@ -142,7 +235,8 @@ RouteBuilder::Endpoint HttpCore::makeEndpoint(const std::string& url, int vptr_t
 
             out.push_back(':');
             out += paramName;
-            params.push_back(makeParam(paramName, RouteBuilder::kString));
+            RouteBuilder::ParamType type = params.size() < paramTypes.size() ? paramTypes[params.size()] : RouteBuilder::kString;
+            params.push_back(makeParam(paramName, type));
             i = end;
         } else {
             out.push_back(url[i]);
@@ -179,6 +273,12 @@ Napi::Value HttpCore::RegisterRoutes(const Napi::CallbackInfo& info) {
     Napi::Array routes = info[0].As<Napi::Array>();
     size_t routeCounts = routes.Length();
 
+    bool staticRouteHash = true;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Value opt = info[1].As<Napi::Object>().Get("staticRouteHash");
+        if (opt.IsBoolean()) staticRouteHash = opt.As<Napi::Boolean>().Value();
+    }
+
     std::unique_ptr<std::vector<RouteBuilder::Endpoint>> methodEndpoints[METHOD_MAX_INDEX_COUNT];
     for (int i = 0; i < METHOD_MAX_INDEX_COUNT; ++i) {
         methodEndpoints[i] = std::make_unique<std::vector<RouteBuilder::Endpoint>>();
@@ -197,19 +297,37 @@ Napi::Value HttpCore::RegisterRoutes(const Napi::CallbackInfo& info) {
         MethodType indexMethod = parserMethod(method);
         if (indexMethod == M_ERROR) continue;
 
-        RouteBuilder::Endpoint ep = makeEndpoint(url, vptr_table_index);
+        std::vector<RouteBuilder::ParamType> paramTypes;
+        Napi::Value typesVal = routeObj.Get("paramTypes");
+        if (typesVal.IsArray()) {
+            Napi::Array types = typesVal.As<Napi::Array>();
+            for (uint32_t t = 0; t < types.Length(); ++t) {
+                Napi::Value type = types[t];
+                paramTypes.push_back(
+                    type.IsNumber() && type.As<Napi::Number>().Int32Value() == RouteBuilder::kNumber
+                        ? RouteBuilder::kNumber : RouteBuilder::kString
+                );
+            }
+        }
+
+        RouteBuilder::Endpoint ep = makeEndpoint(url, vptr_table_index, paramTypes);
 
         methodEndpoints[static_cast<int>(indexMethod)]->push_back(std::move(ep));
     }
 
     for (uint8_t index = 0; index < METHOD_MAX_INDEX_COUNT; ++index) {
         auto& eps = methodEndpoints[index];
+        this->m_httpRouteMaps[index].static_routes = {};
         if (eps && !eps->empty()) {
+            if (staticRouteHash)
+                this->m_httpRouteMaps[index].static_routes = RouteBuilder::buildStaticRouteTable(*eps);
+
             auto routeBuilder = RouteBuilder::buildRouteTree(std::move(*eps));
             
             // RouteBuilder::printRouteTree(routeBuilder); // For Debug
 
             this->m_httpRouteMaps[index].route_node = routeBuilder;
+            this->m_httpRouteMaps[index].route_table = RouteBuilder::freezeRouteTree(routeBuilder);
             setMethodFlag((MethodType)index);
         }
     }
@@ -225,6 +343,7 @@ Napi::Value HttpCore::ScannerRouteFirst(const Napi::CallbackInfo& info) {
     size_t curlLen = curlBuf.Length();
 
     Napi::Object reqObj = info[1].As<Napi::Object>();
+    ScanResult result(info, 7, reqObj);
 
     uint32_t main_offset = 0;
 
@@ -233,8 +352,7 @@ Napi::Value HttpCore::ScannerRouteFirst(const Napi::CallbackInfo& info) {
 
     if (!isMethodAllowed(methodType)) {
         if (methodType == M_ERROR) {
-            uint32_t flags = FLAG_BAD_REQUEST;
-            reqObj.Set("retFlag", Napi::Number::New(env, flags));
+            result.set(RS_RET_FLAG, FLAG_BAD_REQUEST);
             return Napi::Number::New(env, -1);
         }
         
@@ -242,63 +360,93 @@ Napi::Value HttpCore::ScannerRouteFirst(const Napi::CallbackInfo& info) {
         if (methodType == M_OPTIONS)
             flags |= FLAG_CORS_PREFLIGHT;
 
-        reqObj.Set("retFlag", Napi::Number::New(env, flags));
-        reqObj.Set("mainOffset", Napi::Number::New(env, main_offset));
+        result.set(RS_RET_FLAG, flags);
+        result.set(RS_MAIN_OFFSET, main_offset);
         return Napi::Number::New(env, -1);
     }
 
-    reqObj.Set("method", Napi::Number::New(env, (int)methodType));
+    result.set(RS_METHOD, (int)methodType);
 
     main_offset += 1;
 
     Napi::Array params = Napi::Array::New(env);
-    Napi::Object query = Napi::Object::New(env);
+
+    // With a slot bank the query is deferred: only its span is recorded and
+    // decoded later through parseQuery.
+    Napi::Object query;
+    ScratchArena scratch = ScratchArena::fromArg(info, 8);
+    RouteBuilder::QueryOut queryOut;
+    queryOut.scratch = &scratch;
+    if (!result.hasSlots()) {
+        query = Napi::Object::New(env);
+        queryOut.params = &query;
+    }
 
     uint32_t query_limit = info[5].As<Napi::Number>();
     // --------- MATCH ROUTE -------------
-    int routeId = RouteBuilder::matchUrl(env,
-        this->m_httpRouteMaps[methodType].route_node,
+    int routeId = RouteBuilder::matchStaticUrl(env,
+        this->m_httpRouteMaps[methodType].static_routes,
         (const char*)curl,
         curlLen,
         &main_offset,
-        &params,
-        &query,
+        &queryOut,
         query_limit
     );
+
+    if (routeId == -1) {
+        routeId = RouteBuilder::matchUrl(env,
+            this->m_httpRouteMaps[methodType].route_table,
+            (const char*)curl,
+            curlLen,
+            &main_offset,
+            &params,
+            &queryOut,
+            query_limit
+        );
+    }
     
     if(routeId == -1) {
-        reqObj.Set("retFlag", Napi::Number::New(env, FLAG_NOT_FOUND));
+        result.set(RS_RET_FLAG, FLAG_NOT_FOUND);
         return Napi::Number::New(env, -1);
     } else if (routeId == -2) {
-        reqObj.Set("retFlag", Napi::Number::New(env, FLAG_REQUEST_QUERY_EXCEEDED));
+        result.set(RS_RET_FLAG, FLAG_REQUEST_QUERY_EXCEEDED);
         return Napi::Number::New(env, -1);
     } else if (routeId == -3) {
-        reqObj.Set("retFlag", Napi::Number::New(env, FLAG_REQUEST_URL_EXCEEDED));
+        result.set(RS_RET_FLAG, FLAG_REQUEST_URL_EXCEEDED);
         return Napi::Number::New(env, -1);
     }
 
-    reqObj.Set("params", params);
-    reqObj.Set("query", query);
+    if (!result.hasSlots()) {
+        reqObj.Set("params", params);
+        reqObj.Set("query", query);
+    } else {
+        // The caller resets params to an empty array, only hand it over
+        // when the route captured something.
+        if (params.Length() > 0) reqObj.Set("params", params);
+        result.set(RS_QUERY_START, queryOut.start);
+        result.set(RS_QUERY_LEN, queryOut.len);
+    }
 
     main_offset += 1;
     // --------- HTTP VERSION VALIDATION ---------
     bool ret = isHttp11AtOffset((const char*)curl, curlLen, &main_offset);
     if (!ret) {
-        reqObj.Set("retFlag", Napi::Number::New(env, FLAG_HTTP_VERSION_UNSUPPORTED));
+        result.set(RS_RET_FLAG, FLAG_HTTP_VERSION_UNSUPPORTED);
         return Napi::Number::New(env, routeId);
     }
 
     main_offset += 2;
     // --------- HEADER SCANNER ---------
-    uint32_t currentHeaderSize = reqObj.Get("headerSize").As<Napi::Number>();
+    uint32_t currentHeaderSize = result.get(RS_HEADER_SIZE);
     uint32_t maxHeaderNameSize = info[2].As<Napi::Number>();
     uint32_t maxHeaderValueSize = info[3].As<Napi::Number>();
     uint32_t maxHeaderSize = info[4].As<Napi::Number>();
-    Napi::Object headers = reqObj.Get("headers").As<Napi::Object>();
     auto sOff = main_offset;
-    auto res = scanHeaders(env, 
+    auto resume = result.resume();
+    if (resume) resume->state = HttpScanner::HEADER_RESUME_LINE;
+    auto res = scanHeaderBlock(info, 6, reqObj,
                             (const char*)curl, curlLen, 
-                            &main_offset,
+                            &main_offset, false,
                             maxHeaderSize,
 
                             maxHeaderSize,
@@ -306,11 +454,12 @@ Napi::Value HttpCore::ScannerRouteFirst(const Napi::CallbackInfo& info) {
                             currentHeaderSize,
 
                             methodType,
-                            &headers);
-    reqObj.Set("retFlag", (int)res);
-    reqObj.Set("headerSize", Napi::Number::New(env, currentHeaderSize + main_offset - sOff));
+                            resume, &scratch);
+    result.storeResume();
+    result.set(RS_RET_FLAG, (int)res);
+    result.set(RS_HEADER_SIZE, currentHeaderSize + main_offset - sOff);
     // -------- SUCCESS -----------
-    reqObj.Set("mainOffset", Napi::Number::New(env, main_offset));
+    result.set(RS_MAIN_OFFSET, main_offset);
 
     return Napi::Number::New(env, routeId);
 }
@@ -323,19 +472,21 @@ Napi::Value HttpCore::ScannerHeader(const Napi::CallbackInfo& info) {
     size_t curlLen = curlBuf.Length();
 
     Napi::Object reqObj = info[1].As<Napi::Object>();
+    ScanResult result(info, 6, reqObj);
     uint32_t maxHeaderNameSize = info[2].As<Napi::Number>();
     uint32_t maxHeaderValueSize = info[3].As<Napi::Number>();
     uint32_t maxHeaderSize = info[4].As<Napi::Number>();
 
-    uint32_t mainOff = reqObj.Get("mainOffset").As<Napi::Number>();
-    uint32_t currentHeaderSize = reqObj.Get("headerSize").As<Napi::Number>();
+    ScratchArena scratch = ScratchArena::fromArg(info, 7);
+
+    uint32_t mainOff = result.get(RS_MAIN_OFFSET);
+    uint32_t currentHeaderSize = result.get(RS_HEADER_SIZE);
     
-    Napi::Object headers = reqObj.Get("headers").As<Napi::Object>();
-    uint32_t methodType = reqObj.Get("method").As<Napi::Number>(); 
+    uint32_t methodType = result.get(RS_METHOD);
     auto sOff = mainOff;
-    auto res = scanHeaders(env, 
+    auto res = scanHeaderBlock(info, 5, reqObj,
                             (const char*)curl, curlLen, 
-                            &mainOff,
+                            &mainOff, true,
                             maxHeaderSize,
 
                             maxHeaderNameSize,
@@ -343,11 +494,12 @@ Napi::Value HttpCore::ScannerHeader(const Napi::CallbackInfo& info) {
                             currentHeaderSize,
 
                             (MethodType)methodType,
-                            &headers);
-    reqObj.Set("retFlag", (int)res);
-    reqObj.Set("headerSize", Napi::Number::New(env, currentHeaderSize + mainOff - sOff));
+                            result.resume(), &scratch);
+    result.storeResume();
+    result.set(RS_RET_FLAG, (int)res);
+    result.set(RS_HEADER_SIZE, currentHeaderSize + mainOff - sOff);
     // -------- SUCCESS -----------
-    reqObj.Set("mainOffset", Napi::Number::New(env, mainOff));
+    result.set(RS_MAIN_OFFSET, mainOff);
 
     return Napi::Number::New(env, 0);
 }
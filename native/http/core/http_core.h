@@ -32,6 +32,27 @@ enum FlagBits : uint32_t {
     FLAG_SMUGGING_TE_CL            = 0x6000
 };
 
+/// Scalar scan results mirrored into the per-connection Int32Array slot bank
+/// (ChunkProgression.resultSlots) when one is passed to the scanners.
+enum ResultSlot : uint8_t {
+    RS_METHOD,
+    RS_RET_FLAG,
+    RS_MAIN_OFFSET,
+    RS_HEADER_SIZE,
+    RS_QUERY_START, // Deferred query span, decoded on demand by parseQuery
+    RS_QUERY_LEN,
+
+    // Header scan resume state (HttpScanner::HeaderScanState). Optional: a
+    // bank that ends before RS_RESUME_STATE rescans cut-off lines instead.
+    RS_RESUME_STATE,
+    RS_RESUME_HEADER,
+    RS_RESUME_NAME_START,
+    RS_RESUME_NAME_LEN,
+    RS_RESUME_VALUE_START,
+    RS_RESUME_SCAN_POS,
+    RS_COUNT
+};
+
 using MethodFlags = uint8_t;
 
 enum MethodType : uint8_t {
@@ -52,7 +73,9 @@ enum HttpContextMode: uint8_t {
 
 struct HttpRoutes {
     MethodType method_type;
-    shared_ptr<RouteBuilder::RouteNode> route_node; // Builded Route Node
+    shared_ptr<RouteBuilder::RouteNode> route_node; // Builded Route Node (kept for printRouteTree)
+    RouteBuilder::RouteTable route_table; // Frozen route_node walked by matchUrl
+    RouteBuilder::StaticRouteTable static_routes; // Exact-path hash checked before route_table
 };
 
 class HttpCore : public Napi::ObjectWrap<HttpCore> {
@@ -71,13 +94,13 @@ private:
     HttpContextMode m_httpContextMode;
     MethodFlags m_methodFlags = 0;
     HttpRoutes m_httpRouteMaps[METHOD_MAX_INDEX_COUNT] = {
-        { M_HEAD,    nullptr },
-        { M_GET,     nullptr },
-        { M_POST,    nullptr },
-        { M_PUT,     nullptr },
-        { M_DELETE,  nullptr },
-        { M_PATCH,   nullptr },
-        { M_OPTIONS, nullptr },
+        { M_HEAD,    nullptr, {}, {} },
+        { M_GET,     nullptr, {}, {} },
+        { M_POST,    nullptr, {}, {} },
+        { M_PUT,     nullptr, {}, {} },
+        { M_DELETE,  nullptr, {}, {} },
+        { M_PATCH,   nullptr, {}, {} },
+        { M_OPTIONS, nullptr, {}, {} },
     };
 
     // helpers
@@ -85,6 +108,7 @@ private:
     void setMethodFlag(MethodType method);
     bool isMethodAllowed(MethodType method);
 
-    RouteBuilder::Endpoint makeEndpoint(const std::string& url, int vptr_table_index);
+    RouteBuilder::Endpoint makeEndpoint(const std::string& url, int vptr_table_index,
+                                        const std::vector<RouteBuilder::ParamType>& paramTypes = {});
     RouteBuilder::EndpointParam makeParam(const std::string& name, RouteBuilder::ParamType type);
 };
@@ -36,14 +36,6 @@ static inline uint128_t ascii_lower_u128(uint128_t v) {
 #endif
 }
 
-static inline uint128_t load_u128(const char* p) {
-#if SIMD_SSE2
-    return _mm_loadu_si128((const __m128i*)p);
-#elif SIMD_NEON
-    return vld1q_u8(reinterpret_cast<const uint8_t*>(p));
-#endif
-}
-
 static inline uint128_t load_const128(const Pack128& p) {
 #if SIMD_SSE2
     return _mm_set_epi64x(p.hi, p.lo);
@@ -52,23 +44,6 @@ static inline uint128_t load_const128(const Pack128& p) {
 #endif
 }
 
-
-static inline bool simd_eq_n(
-    uint128_t a, uint128_t b, unsigned n
-) {
-#if SIMD_SSE2
-    __m128i mask = mask128_sse(n);
-    __m128i diff = _mm_xor_si128(a, b);
-    diff = _mm_and_si128(diff, mask);
-    return _mm_movemask_epi8(diff) == 0;
-#elif SIMD_NEON
-    uint8x16_t mask = mask128_neon(n);
-    uint8x16_t diff = veorq_u8(a, b);
-    diff = vandq_u8(diff, mask);
-    return vmaxvq_u8(diff) == 0;
-#endif
-}
-
 static inline bool is_hn_delim(char c) {
     return (c == ':' || c == '-' || c == ' ');
 }
@@ -108,21 +83,23 @@ FlagBits HttpScanner::hv_get_value_number(
     uint32_t* __restrict __offset,
     size_t total,
     uint32_t maxHeaderValueSize,
-    std::unique_ptr<std::string>& hv
+    uint32_t* __restrict valueStart,
+    uint32_t* __restrict valueLen
 ) {
-    size_t valueBegin = *__offset;
-    size_t valueEnd   = *__offset;
+    // Numeric values are short, a resumed scan simply starts over.
+    size_t valueBegin = *valueStart;
+    size_t valueEnd   = valueBegin;
+    size_t i          = valueBegin;
     bool seen_digit = false;
 
     while (true) {
-        if (*__offset >= total) {
-            return FLAG_UNTERMINATED_HEADERS;
-        }
+        if (i >= total)
+            goto unterminated;
 
-        if (*__offset - valueBegin > maxHeaderValueSize)
+        if (i - valueBegin > maxHeaderValueSize)
             return FLAG_MAX_HEADER_VALUE_SIZE;
 
-        unsigned char c = (unsigned char)buf[*__offset];
+        unsigned char c = (unsigned char)buf[i];
 
         // ---- Stop at line end ----
         if (c == '\r' || c == '\n')
@@ -131,37 +108,63 @@ FlagBits HttpScanner::hv_get_value_number(
         // ---- Digit or trailing OWS only ----
         if (c >= '0' && c <= '9') {
             seen_digit = true;
-            valueEnd = *__offset + 1;
+            valueEnd = i + 1;
         } else if (c == ' ' || c == '\t') {
             // trailing OWS allowed, do not extend valueEnd
-            (*__offset)++;
+            i++;
             while (true) {
-                if (*__offset >= total)
-                    return FLAG_UNTERMINATED_HEADERS;
+                if (i >= total)
+                    goto unterminated;
 
-                unsigned char c = (unsigned char)buf[*__offset];
+                unsigned char c = (unsigned char)buf[i];
                 if (c == '\r' || c == '\n')
                     break;
 
                 if (c != ' ' && c != '\t' )
                     return FLAG_INVALID_HEADER_VALUE;
 
-                (*__offset)++;
+                i++;
             }
             break;
         } else
             return FLAG_INVALID_HEADER_VALUE;
 
-        (*__offset)++;
+        i++;
     }
 
+    *__offset = (uint32_t)i;
+
     if (!seen_digit)
         return FLAG_INVALID_HEADER_VALUE;
 
-    // ---- Copy value (trimmed) ----
-    hv->assign(buf + valueBegin, valueEnd - valueBegin);
+    // ---- Report value span (trimmed) ----
+    *valueLen = (uint32_t)(valueEnd - valueBegin);
 
     return FLAG_OK;
+
+unterminated:
+    *__offset = (uint32_t)valueBegin;
+    return FLAG_UNTERMINATED_HEADERS;
+}
+
+// Lane mask of the bytes that end a header value scan: CR, LF and every
+// byte hv_is_valid_char rejects (CTLs except HTAB, DEL and >= 0x80).
+static inline uint32_t hv_stop_mask(uint128_t v) {
+#if SIMD_SSE2
+    __m128i ctl = _mm_cmplt_epi8(v, _mm_set1_epi8(32)); // signed: also >= 0x80
+    __m128i tab = _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'));
+    __m128i del = _mm_cmpeq_epi8(v, _mm_set1_epi8(127));
+    return simd_movemask(_mm_or_si128(_mm_andnot_si128(tab, ctl), del));
+#elif SIMD_NEON
+    uint8x16_t ctl = vcltq_s8(vreinterpretq_s8_u8(v), vdupq_n_s8(32)); // signed: also >= 0x80
+    uint8x16_t tab = vceqq_u8(v, vdupq_n_u8('\t'));
+    uint8x16_t del = vceqq_u8(v, vdupq_n_u8(127));
+    return simd_movemask(vorrq_u8(vbicq_u8(ctl, tab), del));
+#endif
+}
+
+static inline bool hv_is_stop_char(unsigned char c) {
+    return (c < 32 && c != '\t') || c >= 127;
 }
 
 FlagBits HttpScanner::hv_get_value_any(
@@ -169,58 +172,85 @@ FlagBits HttpScanner::hv_get_value_any(
     uint32_t* __restrict __offset,
     size_t total,
     uint32_t maxHeaderValueSize,
-    std::unique_ptr<std::string>& hv
+    uint32_t* __restrict valueStart,
+    uint32_t* __restrict valueLen
 ) {
-    size_t valueBegin = *__offset;
-    size_t valueEnd   = *__offset;
-
-    while (true) {
-        if (*__offset >= total)
-            return FLAG_UNTERMINATED_HEADERS;
-
-        if (*__offset - valueBegin > maxHeaderValueSize)
-            return FLAG_MAX_HEADER_VALUE_SIZE;
+    size_t valueBegin = *valueStart;
+
+    // Only bytes within maxHeaderValueSize of the value start may be part of
+    // the value, the one after that is reported as MAX if it is in the buffer.
+    size_t endScan = valueBegin + (size_t)maxHeaderValueSize + 1;
+    if (endScan > total) endScan = total;
+
+    // ---- Find the first CR/LF or invalid byte, 16 bytes per step ----
+    // Bytes before *__offset were already checked by an earlier scan.
+    size_t i = *__offset;
+    while (endScan - i >= 16) {
+        uint32_t m = hv_stop_mask(load_u128(buf + i));
+        if (m) {
+            i += __builtin_ctz(m);
+            goto found;
+        }
+        i += 16;
+    }
+    for (; i < endScan; ++i) {
+        if (hv_is_stop_char((unsigned char)buf[i])) goto found;
+    }
 
-        unsigned char c = (unsigned char)buf[*__offset];
-        // ---- Stop at line end ----
-        if (c == '\r' || c == '\n')
-            break;
+    *__offset = (uint32_t)endScan;
+    return endScan == total ? FLAG_UNTERMINATED_HEADERS : FLAG_MAX_HEADER_VALUE_SIZE;
 
-        // ---- RFC-safe value char validation ----
-        if (c < 32 && c != '\t')
-            return FLAG_INVALID_HEADER_VALUE;
-        if (c == 127)
-            return FLAG_INVALID_HEADER_VALUE;
-        if (!hv_is_valid_char(c))
-            return FLAG_INVALID_HEADER_VALUE;
+found:
+    *__offset = (uint32_t)i;
 
-        // ---- Trim trailing OWS ----
-        if (c != ' ' && c != '\t')
-            valueEnd = *__offset + 1;
+    // ---- Stop at line end, anything else is an RFC-invalid value char ----
+    if (buf[i] != '\r' && buf[i] != '\n')
+        return FLAG_INVALID_HEADER_VALUE;
 
-        (*__offset)++;
-    }
+    // ---- Trim trailing OWS ----
+    size_t valueEnd = i;
+    while (valueEnd > valueBegin && (buf[valueEnd - 1] == ' ' || buf[valueEnd - 1] == '\t'))
+        --valueEnd;
 
-    // ---- Copy value (trimmed) ----
-    hv->assign(buf + valueBegin, valueEnd - valueBegin);
+    // ---- Report value span (trimmed) ----
+    *valueLen = (uint32_t)(valueEnd - valueBegin);
 
     return FLAG_OK;
 }
 
-FlagBits scanHeaders(
-    Napi::Env env, const char* buf, size_t total, uint32_t* offset,
+template <typename Sink>
+static FlagBits scanHeaderLines(
+    const char* buf, size_t total, uint32_t* offset,
     uint32_t maxHeaderSize, uint32_t maxHeaderNameSize, uint32_t maxHeaderValueSize,
-    uint32_t currentHeaderSize, MethodType method, Napi::Object* outHeaders
+    uint32_t currentHeaderSize, MethodType method, Sink& sink,
+    HttpScanner::HeaderScanState* resume
 ) {
+    constexpr uint32_t NO_VALUE = UINT32_MAX;
+
     if (*offset + 1 > total) return FLAG_UNTERMINATED_HEADERS;
 
     uint32_t __offset = *offset;
     std::ptrdiff_t vStart = 0;
+    uint32_t nameLen = 0;
+    uint32_t valueStart = NO_VALUE;
     HeaderId hdrId = HDR_UNKNOWN;
     bool hdrMergeable = false;
-    std::string headerUnknownName;
     State state = ST_STARTUP;
 
+    // ---- Continue a value cut off by the previous buffer end ----
+    if (resume) {
+        if (resume->state == HEADER_RESUME_VALUE) {
+            hdrId        = (HeaderId)(resume->header & HEADER_SPAN_ID_MASK);
+            hdrMergeable = (resume->header & HEADER_SPAN_MERGEABLE) != 0;
+            vStart       = resume->nameStart;
+            nameLen      = resume->nameLen;
+            valueStart   = resume->valueStart;
+            __offset     = resume->scanPos;
+            state        = ST_HV_CONCAT;
+        }
+        resume->state = HEADER_RESUME_LINE;
+    }
+
     while (true) {
         if (__offset >= total && state != ST_HV_CONCAT)
             break;
@@ -311,6 +341,15 @@ FlagBits scanHeaders(
                     state = ST_HN_H;
                     continue;
 
+                // Block-ending CRLF that arrived in a later buffer
+                case '\r':
+                    if (__offset + 1 >= total) return FLAG_UNTERMINATED_HEADERS;
+                    if (buf[__offset + 1] == '\n') {
+                        *offset = __offset + 2;
+                        return FLAG_OK;
+                    }
+                    [[fallthrough]];
+
                 default:
                     vStart = __offset;
                     state = ST_HN_UNKNOWN;
@@ -320,6 +359,7 @@ FlagBits scanHeaders(
 
         // ================= SPACE =================
         case ST_HN_SPACE: {
+            nameLen = __offset - vStart;
             __offset++;
             state = ST_HV_CONCAT;
             continue;
@@ -334,9 +374,7 @@ FlagBits scanHeaders(
                 if (c == ':') {
                     __offset++;
                     hdrId = HDR_UNKNOWN;
-                    headerUnknownName.assign(buf + vStart, __offset - vStart - 1);
-                    std::transform(headerUnknownName.begin(), headerUnknownName.end(), headerUnknownName.begin(),
-                    [](unsigned char c){ return std::tolower(c); });
+                    nameLen = __offset - vStart - 1;
                     state = ST_HV_CONCAT;
                     break;
                 }
@@ -362,7 +400,7 @@ FlagBits scanHeaders(
             if ((lv & MASK_U64_3BYTE) == PACK8("ost")) {
                 __offset += 3;
                 if (buf[__offset] == ':') {
-                    if (outHeaders->Has("host"))
+                    if (sink.has(HDR_HOST))
                             return FLAG_DUPLICATE_SINGLE_HEADER;
                     hdrId = HDR_HOST;
                     state = ST_HN_SPACE;
@@ -397,6 +435,7 @@ FlagBits scanHeaders(
                     // ACCEPT (plain)
                     // --------------------
                     if (c == ':' || c == ' ' || c == '\t') {
+                        hdrMergeable = true;
                         hdrId = HDR_ACCEPT;
                         state = ST_HN_SPACE;
                         continue; 
@@ -481,7 +520,7 @@ FlagBits scanHeaders(
                 if (simd_eq_n(v, load_const128(P_THORIZATION), 11)) {
                     __offset += 11;
                     if (buf[__offset] == ':') {
-                        if (outHeaders->Has("authorization"))
+                        if (sink.has(HDR_AUTHORIZATION))
                             return FLAG_DUPLICATE_SINGLE_HEADER;
 
                         hdrId = HDR_AUTHORIZATION;
@@ -605,9 +644,9 @@ FlagBits scanHeaders(
                                 if ((lw & MASK_U64_5BYTE) == PACK8("ength")) {
                                     __offset += 6;
                                     if (buf[__offset] == ':') {
-                                        if (outHeaders->Has("content-length"))
+                                        if (sink.has(HDR_CONTENT_LENGTH))
                                             return FLAG_DUPLICATE_SINGLE_HEADER;
-                                        if (outHeaders->Has("transfer-encoding"))
+                                        if (sink.has(HDR_TRANSFER_ENCODING))
                                             return FLAG_BAD_REQUEST;
                                             
                                         hdrId = HDR_CONTENT_LENGTH;
@@ -623,7 +662,7 @@ FlagBits scanHeaders(
                                 if ((lw & MASK_U64_3BYTE) == PACK8("ype")) {
                                     __offset += 4;
                                     if (buf[__offset] == ':') {
-                                        if (outHeaders->Has("content-type"))
+                                        if (sink.has(HDR_CONTENT_TYPE))
                                             return FLAG_DUPLICATE_SINGLE_HEADER;
                                         hdrId = HDR_CONTENT_TYPE;
                                         state = ST_HN_SPACE;
@@ -638,7 +677,7 @@ FlagBits scanHeaders(
                                 if ((lw & MASK_U64_4BYTE) == PACK8("ange")) {
                                     __offset += 5;
                                     if (buf[__offset] == ':') { 
-                                        if (outHeaders->Has("content-range"))
+                                        if (sink.has(HDR_CONTENT_RANGE))
                                             return FLAG_DUPLICATE_SINGLE_HEADER;
                                         hdrId = HDR_CONTENT_RANGE;
                                         state = ST_HN_SPACE;
@@ -672,7 +711,7 @@ FlagBits scanHeaders(
                 if (w == (('t' << 16) | ('e' << 8))) {
                     __offset += 3;
                     if (buf[__offset] == ':') { 
-                        if (outHeaders->Has("date"))
+                        if (sink.has(HDR_DATE))
                             return FLAG_DUPLICATE_SINGLE_HEADER;
                         hdrId = HDR_DATE;
                         state = ST_HN_SPACE;
@@ -726,7 +765,7 @@ FlagBits scanHeaders(
                 if (simd_eq_n(v, load_const128(P_ONE_MATCH), 9)) {
                     __offset += 9; // "if-none-match"
                     if (buf[__offset] == ':') { 
-                        if (outHeaders->Has("if-none-match")) 
+                        if (sink.has(HDR_IF_NONE_MATCH)) 
                             return FLAG_DUPLICATE_SINGLE_HEADER;
                         hdrId = HDR_IF_NONE_MATCH;
                         state = ST_HN_SPACE;
@@ -749,7 +788,7 @@ FlagBits scanHeaders(
                 if (lt == PACK8("atch")) {
                     __offset += 4; // "if-match"
                     if (buf[__offset] == ':') { 
-                        if (outHeaders->Has("if-match")) 
+                        if (sink.has(HDR_IF_MATCH)) 
                             return FLAG_DUPLICATE_SINGLE_HEADER;
                         hdrId = HDR_IF_MATCH;
                         state = ST_HN_SPACE;
@@ -770,7 +809,7 @@ FlagBits scanHeaders(
                 if (simd_eq_n(v, load_const128(P_ODIFIED_SINCE), 13)) {
                     __offset += 13; // "if-modified-since"
                     if (buf[__offset] == ':') { 
-                        if (outHeaders->Has("if-modified-since")) 
+                        if (sink.has(HDR_IF_MODIFIED_SINCE)) 
                             return FLAG_DUPLICATE_SINGLE_HEADER;
                         hdrId = HDR_IF_MODIFIED_SINCE;
                         state = ST_HN_SPACE;
@@ -796,7 +835,7 @@ FlagBits scanHeaders(
                 if (simd_eq_n(v, load_const128(P_UNMODIFIED_SINCE), 15)) {
                     __offset += 15; // "if-unmodified-since"
                     if (buf[__offset] == ':') { 
-                        if (outHeaders->Has("if-unmodified-since")) 
+                        if (sink.has(HDR_IF_UNMODIFIED_SINCE)) 
                             return FLAG_DUPLICATE_SINGLE_HEADER;
                         hdrId = HDR_IF_UNMODIFIED_SINCE;
                         state = ST_HN_SPACE;
@@ -897,7 +936,7 @@ FlagBits scanHeaders(
                 
                 __offset += 5;
                 if (buf[__offset] == ':') { 
-                    if (outHeaders->Has("origin"))
+                    if (sink.has(HDR_ORIGIN))
                         return FLAG_DUPLICATE_SINGLE_HEADER;
                     hdrId = HDR_ORIGIN;
                     state = ST_HN_SPACE;
@@ -949,7 +988,7 @@ FlagBits scanHeaders(
                     if (lw == PACK8("rization")) {
                         __offset += 8;
                         if (buf[__offset] == ':') { 
-                            if (outHeaders->Has("proxy-authorization"))
+                            if (sink.has(HDR_PROXY_AUTHORIZATION))
                                 return FLAG_DUPLICATE_SINGLE_HEADER;
                             hdrId = HDR_PROXY_AUTHORIZATION;
                             state = ST_HN_SPACE;
@@ -1160,9 +1199,9 @@ FlagBits scanHeaders(
                     if (simd_eq_n(v, load_const128(P_SFER_ENCODING_), 13)) {
                         __offset += 13;
                         if (buf[__offset] == ':') { 
-                            if (outHeaders->Has("transfer-encoding"))
+                            if (sink.has(HDR_TRANSFER_ENCODING))
                                 return FLAG_DUPLICATE_SINGLE_HEADER;
-                            if (outHeaders->Has("content-length"))
+                            if (sink.has(HDR_CONTENT_LENGTH))
                                 return FLAG_BAD_REQUEST;
 
                             hdrId = HDR_TRANSFER_ENCODING;
@@ -1213,7 +1252,7 @@ FlagBits scanHeaders(
                 if (lw == PACK8("er-agent")) {
                     __offset += 8;
                     if (buf[__offset] == ':') { 
-                        if (outHeaders->Has("user-agent")) 
+                        if (sink.has(HDR_USER_AGENT)) 
                             return FLAG_DUPLICATE_SINGLE_HEADER;
                         hdrId = HDR_USER_AGENT;
                         state = ST_HN_SPACE;
@@ -1250,7 +1289,7 @@ FlagBits scanHeaders(
         case ST_HN_V: {
             if (__offset + 2 > total) return FLAG_UNTERMINATED_HEADERS;
             uint64_t w = load_u64(buf + __offset);
-            uint64_t lw = ascii_lower_u64(w) % MASK_U64_2BYTE;
+            uint64_t lw = ascii_lower_u64(w) & MASK_U64_2BYTE;
 
             // -------------------------------------------------
             // via
@@ -1258,6 +1297,7 @@ FlagBits scanHeaders(
             if (lw == PACK8("ia")) {
                 __offset += 2;
                 if (buf[__offset] == ':') { 
+                    hdrMergeable = true;
                     hdrId = HDR_VIA;
                     state = ST_HN_SPACE;
                     continue;
@@ -1357,6 +1397,7 @@ FlagBits scanHeaders(
                 if (simd_eq_n(v, load_const128(P_ORWARDED_FOR), 12)) {
                     __offset += 12;
                     if (buf[__offset] == ':') { 
+                        hdrMergeable = true;
                         hdrId = HDR_X_FORWARDED_FOR;
                         state = ST_HN_SPACE;
                         continue;
@@ -1416,24 +1457,32 @@ FlagBits scanHeaders(
 
         // =============== VALUE ===============
         case ST_HV_CONCAT: {
-            // ---- Skip leading OWS ----
-            while (__offset < total &&
-                (buf[__offset] == ' ' || buf[__offset] == '\t'))
-                __offset++;
+            // ---- Skip leading OWS (unless resuming inside the value) ----
+            if (valueStart == NO_VALUE || __offset == valueStart) {
+                while (__offset < total &&
+                    (buf[__offset] == ' ' || buf[__offset] == '\t'))
+                    __offset++;
+                valueStart = __offset;
+            }
 
             // ---- Scan header value ----
-            auto hv = std::make_unique<std::string>();
+            uint32_t valueLen = 0;
             FlagBits ret = HEADERS[hdrId].value_parser(
-                buf, &__offset, total, maxHeaderValueSize, hv
+                buf, &__offset, total, maxHeaderValueSize, &valueStart, &valueLen
             );
 
+            if (ret == FLAG_UNTERMINATED_HEADERS) {
+                goto save_value;
+            }
             if (ret != FLAG_OK) {
                 return ret;
             }
 
             // ---- Consume CRLF or LF ----
             if (buf[__offset] == '\r') {
-                if (__offset + 1 >= total || buf[__offset + 1] != '\n')
+                if (__offset + 1 >= total)
+                    goto save_value;
+                if (buf[__offset + 1] != '\n')
                     return FLAG_INVALID_HEADER_VALUE;
                 __offset += 2;
             }
@@ -1445,33 +1494,10 @@ FlagBits scanHeaders(
             *offset  = __offset;
 
             // ---- Store header value ----
-            auto value = Napi::String::New(
-                env,
-                hv->c_str()
-            );
-
-            if (hdrId == HDR_UNKNOWN) {
-                outHeaders->Set(headerUnknownName, value);
-            } else {
-                const char* name = HEADERS[hdrId].name;
-
-                if (hdrMergeable && outHeaders->Has(name)) {
-                    auto oldVal =
-                        outHeaders->Get(name)
-                            .As<Napi::String>()
-                            .Utf8Value();
-
-                    outHeaders->Set(
-                        name,
-                        Napi::String::New(
-                            env,
-                            oldVal + ", " + value.Utf8Value()
-                        )
-                    );
-                    hdrMergeable = false;
-                } else {
-                    outHeaders->Set(name, value);
-                }
+            ret = sink.emit(buf, hdrId, hdrMergeable,
+                            vStart, nameLen, valueStart, valueLen);
+            if (ret != FLAG_OK) {
+                return ret;
             }
 
             // ---- HEADER BLOCK END? (CRLF CRLF) ----
@@ -1489,7 +1515,8 @@ FlagBits scanHeaders(
             // ---- Reset per-header state ----
             hdrId = HDR_UNKNOWN;
             hdrMergeable = false;
-            headerUnknownName.clear();
+            nameLen = 0;
+            valueStart = NO_VALUE;
 
             // ---- Continue parsing next header ----
             state = ST_STARTUP;
@@ -1499,4 +1526,196 @@ FlagBits scanHeaders(
     }
     
     return FLAG_UNTERMINATED_HEADERS;
+
+save_value:
+    if (resume) {
+        resume->state      = HEADER_RESUME_VALUE;
+        resume->header     = hdrId | (hdrMergeable ? HEADER_SPAN_MERGEABLE : 0);
+        resume->nameStart  = (uint32_t)vStart;
+        resume->nameLen    = nameLen;
+        resume->valueStart = valueStart;
+        resume->scanPos    = __offset;
+    }
+    return FLAG_UNTERMINATED_HEADERS;
+}
+
+template <typename Sink>
+FlagBits scanHeaders(
+    const char* buf, size_t total, uint32_t* offset,
+    uint32_t maxHeaderSize, uint32_t maxHeaderNameSize, uint32_t maxHeaderValueSize,
+    uint32_t currentHeaderSize, MethodType method, Sink& sink,
+    HttpScanner::HeaderScanState* resume
+) {
+    FlagBits ret = scanHeaderLines(buf, total, offset,
+                                   maxHeaderSize, maxHeaderNameSize, maxHeaderValueSize,
+                                   currentHeaderSize, method, sink, resume);
+
+    // Spans still point into buf, so buffered headers are written out on
+    // every exit, including a partial block that will be resumed later.
+    sink.finish(buf);
+    return ret;
+}
+
+//===----------------------------------------------------------------------===//
+// Header sinks
+//===----------------------------------------------------------------------===//
+
+HttpScanner::ObjectHeaderSink::ObjectHeaderSink(Napi::Env env, Napi::Object* outHeaders, ScratchArena* scratch)
+: env(env), outHeaders(outHeaders), scratch(scratch), mergeCount(0), pending(0) {}
+
+bool HttpScanner::ObjectHeaderSink::has(HeaderId id) {
+    if ((pending >> id) & 1) return true;
+    return outHeaders->Has(HEADERS[id].name);
+}
+
+FlagBits HttpScanner::ObjectHeaderSink::emit(
+    const char* buf, HeaderId id, bool mergeable,
+    uint32_t nameStart, uint32_t nameLen,
+    uint32_t valueStart, uint32_t valueLen
+) {
+    if (id == HDR_UNKNOWN) {
+        auto value = Napi::String::New(env, buf + valueStart, valueLen);
+        size_t mark = scratch ? scratch->mark() : 0;
+        char* lower = scratch ? scratch->alloc(nameLen) : nullptr;
+
+        if (lower) {
+            std::transform(buf + nameStart, buf + nameStart + nameLen, lower,
+            [](unsigned char c){ return std::tolower(c); });
+            outHeaders->Set(Napi::String::New(env, lower, nameLen), value);
+            scratch->rewind(mark);
+            return FLAG_OK;
+        }
+
+        unknownName.assign(buf + nameStart, nameLen);
+        std::transform(unknownName.begin(), unknownName.end(), unknownName.begin(),
+        [](unsigned char c){ return std::tolower(c); });
+        outHeaders->Set(unknownName, value);
+        return FLAG_OK;
+    }
+
+    if (!mergeable) {
+        outHeaders->Set(HEADERS[id].name, Napi::String::New(env, buf + valueStart, valueLen));
+        return FLAG_OK;
+    }
+
+    // Table full: write out what we have, later lines merge onto it.
+    if (mergeCount == MAX_MERGE_SPANS) [[unlikely]]
+        finish(buf);
+
+    merges[mergeCount++] = { id, valueStart, valueLen };
+    pending |= (uint64_t)1 << id;
+
+    return FLAG_OK;
+}
+
+void HttpScanner::ObjectHeaderSink::finish(const char* buf) {
+    uint64_t done = 0;
+
+    for (uint32_t i = 0; i < mergeCount; ++i) {
+        HeaderId id = merges[i].id;
+        if ((done >> id) & 1) continue;
+        done |= (uint64_t)1 << id;
+
+        const char* name = HEADERS[id].name;
+
+        // Only a resumed or overflowed block can already hold this header.
+        bool existing = outHeaders->Has(name);
+        uint32_t j = i + 1;
+        while (j < mergeCount && merges[j].id != id) ++j;
+
+        if (!existing && j == mergeCount) {
+            outHeaders->Set(name, Napi::String::New(env, buf + merges[i].valueStart, merges[i].valueLen));
+            continue;
+        }
+
+        Napi::Value prev;
+        size_t prevLen = 0;
+        size_t len = 0;
+        if (existing) {
+            prev = outHeaders->Get(name);
+            napi_get_value_string_utf8(env, prev, nullptr, 0, &prevLen);
+            len = prevLen;
+        }
+        for (uint32_t k = i; k < mergeCount; ++k) {
+            if (merges[k].id == id) len += 2 + merges[k].valueLen;
+        }
+
+        // +1: napi_get_value_string_utf8 always writes a terminator.
+        size_t mark = scratch ? scratch->mark() : 0;
+        char* out = scratch ? scratch->alloc(len + 1) : nullptr;
+        if (!out) {
+            merged.resize(len + 1);
+            out = merged.data();
+        }
+
+        size_t n = 0;
+        if (existing)
+            napi_get_value_string_utf8(env, prev, out, prevLen + 1, &n);
+
+        for (uint32_t k = i; k < mergeCount; ++k) {
+            if (merges[k].id != id) continue;
+            if (existing || k != i) {
+                out[n++] = ',';
+                out[n++] = ' ';
+            }
+            std::memcpy(out + n, buf + merges[k].valueStart, merges[k].valueLen);
+            n += merges[k].valueLen;
+        }
+
+        outHeaders->Set(name, Napi::String::New(env, out, n));
+        if (scratch) scratch->rewind(mark);
+    }
+
+    mergeCount = 0;
+    pending = 0;
+}
+
+HttpScanner::SpanHeaderSink::SpanHeaderSink(uint32_t* table, size_t tableLen)
+: table(table), seen(0) {
+    capacity = tableLen > HEADER_SPAN_HEAD
+        ? (uint32_t)((tableLen - HEADER_SPAN_HEAD) / HEADER_SPAN_STRIDE)
+        : 0;
+
+    // Rebuild the duplicate mask when resuming a partially scanned block.
+    uint32_t count = table[HEADER_SPAN_COUNT_SLOT];
+    if (count > capacity) count = table[HEADER_SPAN_COUNT_SLOT] = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t id = table[HEADER_SPAN_HEAD + i * HEADER_SPAN_STRIDE] & HEADER_SPAN_ID_MASK;
+        seen |= (uint64_t)1 << id;
+    }
+}
+
+bool HttpScanner::SpanHeaderSink::has(HeaderId id) {
+    return (seen >> id) & 1;
+}
+
+FlagBits HttpScanner::SpanHeaderSink::emit(
+    const char* buf, HeaderId id, bool mergeable,
+    uint32_t nameStart, uint32_t nameLen,
+    uint32_t valueStart, uint32_t valueLen
+) {
+    uint32_t count = table[HEADER_SPAN_COUNT_SLOT];
+    if (count >= capacity) [[unlikely]]
+        return FLAG_MAX_HEADER_SIZE;
+
+    uint32_t* t = table + HEADER_SPAN_HEAD + count * HEADER_SPAN_STRIDE;
+    t[0] = id | (mergeable ? HEADER_SPAN_MERGEABLE : 0);
+    t[1] = nameStart;
+    t[2] = nameLen;
+    t[3] = valueStart;
+    t[4] = valueLen;
+
+    seen |= (uint64_t)1 << id;
+    table[HEADER_SPAN_COUNT_SLOT] = count + 1;
+
+    return FLAG_OK;
 }
+
+template FlagBits scanHeaders<HttpScanner::ObjectHeaderSink>(
+    const char*, size_t, uint32_t*, uint32_t, uint32_t, uint32_t, uint32_t,
+    MethodType, HttpScanner::ObjectHeaderSink&, HttpScanner::HeaderScanState*
+);
+template FlagBits scanHeaders<HttpScanner::SpanHeaderSink>(
+    const char*, size_t, uint32_t*, uint32_t, uint32_t, uint32_t, uint32_t,
+    MethodType, HttpScanner::SpanHeaderSink&, HttpScanner::HeaderScanState*
+);
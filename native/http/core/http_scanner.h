@@ -5,73 +5,8 @@
 
 #include "http_core.h"
 
-FlagBits scanHeaders(
-    Napi::Env env, const char* buf, size_t total, uint32_t* offset,
-    uint32_t maxContentLength, uint32_t maxHeaderNameSize, uint32_t maxHeaderValueSize,
-    uint32_t currentHeaderSize, MethodType method, Napi::Object* outHeaders
-);
-
-#if defined(__ARM_NEON) || defined(__ARM_NEON__)
-    #define SIMD_NEON 1
-
-#elif defined(__SSE2__) || defined(__AVX2__) || defined(_M_X64) || defined(_M_AMD64)
-    #define SIMD_SSE2 1
-
-#else
-    #error "No SIMD backend (SSE2/AVX2/NEON required)"
-#endif
-
-#if SIMD_SSE2
-    #include <immintrin.h>
-    using uint128_t = __m128i;
-    static inline __m128i mask128_sse(unsigned n) {
-        static const uint8_t masks[17][16] = {
-            {0},
-            {0xFF},
-            {0xFF,0xFF},
-            {0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-        };
-        return _mm_loadu_si128((const __m128i*)masks[n]);
-    }
-#elif SIMD_NEON
-    #include <arm_neon.h>
-    using uint128_t = uint8x16_t;
-    static inline uint8x16_t mask128_neon(unsigned n) {
-        static const uint8_t table[17][16] = {
-            {0},
-            {0xFF},
-            {0xFF,0xFF},
-            {0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
-            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF}
-        };
-        return vld1q_u8(table[n]);
-    }
-#endif
+#include "simd.h"
+#include "scratch_arena.h"
 
 namespace HttpScanner {
 
@@ -336,7 +271,7 @@ namespace HttpScanner {
         HDR_WWW_AUTHENTICATE,
         HDR_PROXY_AUTHENTICATE,
         HDR_LINK,
-        HDR_VIA,
+        HDR_VIA,                // comma list, merged in order like X-Forwarded-For
 
         // ─────────────
         // MERGEABLE (comma-separated)
@@ -379,12 +314,19 @@ namespace HttpScanner {
         HDR_X_REAL_IP
     };
 
+    /// Value parsers read the value that begins at *valueStart (after
+    /// leading OWS) and continue scanning at *__offset, which is past
+    /// valueStart only when resuming a cut-off value. On success
+    /// *valueStart / *valueLen hold the trimmed value span. On
+    /// FLAG_UNTERMINATED_HEADERS *__offset is where a resumed scan may
+    /// continue from.
     typedef FlagBits (*hv_value_parser_fn)(
         const char* __restrict buf, 
         uint32_t* __restrict __offset, 
         size_t total, 
         uint32_t maxHeaderValueSize, 
-        std::unique_ptr<std::string>& hv
+        uint32_t* __restrict valueStart,
+        uint32_t* __restrict valueLen
     );
 
     typedef struct {
@@ -397,14 +339,16 @@ namespace HttpScanner {
         uint32_t* __restrict __offset, 
         size_t total, 
         uint32_t maxHeaderValueSize, 
-        std::unique_ptr<std::string>& hv
+        uint32_t* __restrict valueStart,
+        uint32_t* __restrict valueLen
     );
     FlagBits hv_get_value_any(
         const char* __restrict buf, 
         uint32_t* __restrict __offset, 
         size_t total, 
         uint32_t maxHeaderValueSize, 
-        std::unique_ptr<std::string>& hv
+        uint32_t* __restrict valueStart,
+        uint32_t* __restrict valueLen
     );
 
     const HeaderDesc HEADERS[] = {
@@ -473,4 +417,95 @@ namespace HttpScanner {
         { "x-forwarded-host", hv_get_value_any },
         { "x-real-ip", hv_get_value_any }
     };
-}
\ No newline at end of file
+
+    static_assert(HDR_X_REAL_IP < 64, "HeaderId must fit the 64-bit duplicate mask");
+
+    /// Layout of the per-connection header span table (Uint32Array).
+    /// Slot 0 holds the number of committed headers, followed by
+    /// HEADER_SPAN_STRIDE-wide tuples of
+    /// (HeaderId | flags, nameStart, nameLen, valueStart, valueLen).
+    /// Offsets are relative to the buffer that was scanned.
+    constexpr uint32_t HEADER_SPAN_COUNT_SLOT = 0;
+    constexpr uint32_t HEADER_SPAN_HEAD       = 1;
+    constexpr uint32_t HEADER_SPAN_STRIDE     = 5;
+    constexpr uint32_t HEADER_SPAN_ID_MASK    = 0xFFFF;
+    constexpr uint32_t HEADER_SPAN_MERGEABLE  = 1u << 16;
+
+    /// Progress of a header line cut off by the end of the buffer. Kept in
+    /// the per-connection slot bank so the next scan continues inside the
+    /// value instead of rescanning it.
+    constexpr uint32_t HEADER_RESUME_LINE  = 0; // restart at the committed line offset
+    constexpr uint32_t HEADER_RESUME_VALUE = 1; // continue the value scan at scanPos
+
+    struct HeaderScanState {
+        uint32_t state;
+        uint32_t header;      // HeaderId | HEADER_SPAN_MERGEABLE
+        uint32_t nameStart;
+        uint32_t nameLen;
+        uint32_t valueStart;
+        uint32_t scanPos;
+    };
+
+    /// Maximum number of mergeable header lines buffered per scan before
+    /// they are flushed to the headers object early.
+    constexpr uint32_t MAX_MERGE_SPANS = 32;
+
+    /// Materializes every header as a property on a JS object.
+    ///
+    /// Mergeable headers are not written as they are scanned; their value
+    /// spans are collected in a fixed table and each header is joined with
+    /// ", " and set exactly once by finish().
+    struct ObjectHeaderSink {
+        struct MergeSpan {
+            HeaderId id;
+            uint32_t valueStart;
+            uint32_t valueLen;
+        };
+
+        Napi::Env env;
+        Napi::Object* outHeaders;
+        ScratchArena* scratch;    // lowercased names and merged values, optional
+        std::string unknownName;  // heap fallback when scratch is missing or full
+        std::string merged;
+
+        MergeSpan merges[MAX_MERGE_SPANS];
+        uint32_t mergeCount;
+        uint64_t pending;
+
+        ObjectHeaderSink(Napi::Env env, Napi::Object* outHeaders, ScratchArena* scratch = nullptr);
+
+        bool has(HeaderId id);
+        FlagBits emit(
+            const char* buf, HeaderId id, bool mergeable,
+            uint32_t nameStart, uint32_t nameLen,
+            uint32_t valueStart, uint32_t valueLen
+        );
+        void finish(const char* buf);
+    };
+
+    /// Records header offsets into a preallocated span table without
+    /// creating any JS values. Duplicate checks use a HeaderId bitmask.
+    struct SpanHeaderSink {
+        uint32_t* table;
+        uint32_t capacity;
+        uint64_t seen;
+
+        SpanHeaderSink(uint32_t* table, size_t tableLen);
+
+        bool has(HeaderId id);
+        FlagBits emit(
+            const char* buf, HeaderId id, bool mergeable,
+            uint32_t nameStart, uint32_t nameLen,
+            uint32_t valueStart, uint32_t valueLen
+        );
+        void finish(const char*) {}
+    };
+}
+
+template <typename Sink>
+FlagBits scanHeaders(
+    const char* buf, size_t total, uint32_t* offset,
+    uint32_t maxHeaderSize, uint32_t maxHeaderNameSize, uint32_t maxHeaderValueSize,
+    uint32_t currentHeaderSize, MethodType method, Sink& sink,
+    HttpScanner::HeaderScanState* resume = nullptr
+);
\ No newline at end of file
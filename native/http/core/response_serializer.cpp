@@ -0,0 +1,278 @@
+#include "response_serializer.h"
+#include "simd.h"
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t STATUS_MIN = 100;
+constexpr uint32_t STATUS_MAX = 599;
+constexpr uint32_t STATUS_LINE_CAP = 64;
+
+const char* reasonPhrase(uint32_t code) {
+    switch (code) {
+        case 100: return "Continue";
+        case 101: return "Switching Protocols";
+        case 102: return "Processing";
+        case 103: return "Early Hints";
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 203: return "Non-Authoritative Information";
+        case 204: return "No Content";
+        case 205: return "Reset Content";
+        case 206: return "Partial Content";
+        case 207: return "Multi-Status";
+        case 208: return "Already Reported";
+        case 226: return "IM Used";
+        case 300: return "Multiple Choices";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 303: return "See Other";
+        case 304: return "Not Modified";
+        case 305: return "Use Proxy";
+        case 307: return "Temporary Redirect";
+        case 308: return "Permanent Redirect";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 402: return "Payment Required";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 406: return "Not Acceptable";
+        case 407: return "Proxy Authentication Required";
+        case 408: return "Request Timeout";
+        case 409: return "Conflict";
+        case 410: return "Gone";
+        case 411: return "Length Required";
+        case 412: return "Precondition Failed";
+        case 413: return "Payload Too Large";
+        case 414: return "URI Too Long";
+        case 415: return "Unsupported Media Type";
+        case 416: return "Range Not Satisfiable";
+        case 417: return "Expectation Failed";
+        case 418: return "I'm a Teapot";
+        case 421: return "Misdirected Request";
+        case 422: return "Unprocessable Content";
+        case 423: return "Locked";
+        case 424: return "Failed Dependency";
+        case 425: return "Too Early";
+        case 426: return "Upgrade Required";
+        case 428: return "Precondition Required";
+        case 429: return "Too Many Requests";
+        case 431: return "Request Header Fields Too Large";
+        case 451: return "Unavailable For Legal Reasons";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        case 505: return "HTTP Version Not Supported";
+        case 506: return "Variant Also Negotiates";
+        case 507: return "Insufficient Storage";
+        case 508: return "Loop Detected";
+        case 510: return "Not Extended";
+        case 511: return "Network Authentication Required";
+        default:  return "";
+    }
+}
+
+struct StatusLineTable {
+    char lines[STATUS_MAX - STATUS_MIN + 1][STATUS_LINE_CAP];
+    uint8_t lens[STATUS_MAX - STATUS_MIN + 1];
+
+    StatusLineTable() {
+        for (uint32_t code = STATUS_MIN; code <= STATUS_MAX; ++code) {
+            char* w = lines[code - STATUS_MIN];
+            const char* reason = reasonPhrase(code);
+            size_t reasonLen = strlen(reason);
+
+            memcpy(w, "HTTP/1.1 ", 9);
+            w[9]  = (char)('0' + code / 100);
+            w[10] = (char)('0' + code / 10 % 10);
+            w[11] = (char)('0' + code % 10);
+            w[12] = ' ';
+            memcpy(w + 13, reason, reasonLen);
+            w[13 + reasonLen] = '\r';
+            w[14 + reasonLen] = '\n';
+            lens[code - STATUS_MIN] = (uint8_t)(15 + reasonLen);
+        }
+    }
+};
+
+const StatusLineTable& statusLineTable() {
+    static const StatusLineTable table;
+    return table;
+}
+
+constexpr char CONTENT_LENGTH[] = "content-length";
+constexpr uint32_t CONTENT_LENGTH_LEN = sizeof(CONTENT_LENGTH) - 1;
+
+inline bool isContentLength(const char* p, size_t n) {
+    if (n != CONTENT_LENGTH_LEN) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if ((p[i] | 0x20) != CONTENT_LENGTH[i]) return false;
+    }
+    return true;
+}
+
+// CR, LF or NUL inside a header would split the response.
+inline bool hasForbiddenByte(const char* p, size_t n) {
+    return simd_find_any<'\r', '\n', '\0'>(p, p + n) != p + n;
+}
+
+// Copies a string as latin1 to *w. False when it does not fit (napi needs
+// one byte more for its terminator, a full buffer may mean truncation).
+inline bool writeLatin1(napi_env env, napi_value v, char*& w, char* end, size_t* n) {
+    size_t room = (size_t)(end - w);
+    if (room < 2) return false;
+    if (napi_get_value_string_latin1(env, v, w, room, n) != napi_ok) {
+        throw Napi::TypeError::New(env, "Header keys and values must be strings");
+    }
+    return *n < room - 1;
+}
+
+}
+
+namespace ResponseSerializer {
+
+const char* statusLine(uint32_t status, uint32_t* len) {
+    if (status < STATUS_MIN || status > STATUS_MAX) return nullptr;
+    const StatusLineTable& t = statusLineTable();
+    *len = t.lens[status - STATUS_MIN];
+    return t.lines[status - STATUS_MIN];
+}
+
+uint32_t writeDecimal(char* dst, uint64_t v) {
+    char tmp[20];
+    uint32_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (uint32_t i = 0; i < n; ++i) dst[i] = tmp[n - 1 - i];
+    return n;
+}
+
+}
+
+Napi::Value SerializeResponse(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 5 || !info[0].IsNumber() || !info[1].IsArray() || !info[2].IsArray() || !info[4].IsBuffer()) [[unlikely]] {
+        Napi::TypeError::New(env, "Expected (status: number, headerKeys: string[], headerValues: string[], body: Buffer | string | number, outBuf: Buffer, headerCount?: number, staticHeaders?: Buffer, dateHeader?: Buffer)").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    uint32_t statusLen = 0;
+    const char* status = ResponseSerializer::statusLine(info[0].As<Napi::Number>().Uint32Value(), &statusLen);
+    if (!status) [[unlikely]] {
+        Napi::RangeError::New(env, "Status code out of range").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto keys = info[1].As<Napi::Array>();
+    auto values = info[2].As<Napi::Array>();
+    uint32_t count = keys.Length();
+    if (values.Length() != count) [[unlikely]] {
+        Napi::TypeError::New(env, "headerKeys and headerValues must have the same length").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    // Pooled responses keep their header arrays and only reset a count.
+    if (info.Length() > 5 && info[5].IsNumber()) {
+        uint32_t live = info[5].As<Napi::Number>().Uint32Value();
+        if (live < count) count = live;
+    }
+
+    // Body: copied behind the head (Buffer / string) or length only (number).
+    Napi::Value body = info[3];
+    const char* bodyData = nullptr;
+    size_t bodyLen = 0;
+    bool bodyString = false;
+    if (body.IsBuffer()) {
+        auto b = body.As<Napi::Buffer<char>>();
+        bodyData = b.Data();
+        bodyLen = b.Length();
+    } else if (body.IsString()) {
+        napi_get_value_string_utf8(env, body, nullptr, 0, &bodyLen);
+        bodyString = true;
+    } else if (body.IsNumber()) {
+        bodyLen = (size_t)body.As<Napi::Number>().Int64Value();
+    } else if (!body.IsUndefined() && !body.IsNull()) [[unlikely]] {
+        Napi::TypeError::New(env, "body must be a Buffer, string or number").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto out = info[4].As<Napi::Buffer<char>>();
+    char* const base = out.Data();
+    char* const end = base + out.Length();
+    char* w = base;
+    const Napi::Number tooSmall = Napi::Number::New(env, -1);
+
+    if ((size_t)(end - w) < statusLen) return tooSmall;
+    memcpy(w, status, statusLen);
+    w += statusLen;
+
+    // Pre-encoded header lines: the cached Date line, then the route's
+    // static headers.
+    for (size_t arg : { (size_t)7, (size_t)6 }) {
+        if (info.Length() <= arg || !info[arg].IsBuffer()) continue;
+        auto block = info[arg].As<Napi::Buffer<char>>();
+        if ((size_t)(end - w) < block.Length()) return tooSmall;
+        memcpy(w, block.Data(), block.Length());
+        w += block.Length();
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value k = keys.Get(i);
+        napi_value v = values.Get(i);
+        size_t n = 0;
+
+        char* line = w;
+        if (!writeLatin1(env, k, w, end, &n)) return tooSmall;
+        // Content-Length is always derived from the body below.
+        if (isContentLength(line, n)) continue;
+        if (hasForbiddenByte(line, n)) [[unlikely]] {
+            Napi::TypeError::New(env, "Invalid character in response header name").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        w += n;
+
+        if (end - w < 2) return tooSmall;
+        *w++ = ':';
+        *w++ = ' ';
+
+        char* value = w;
+        if (!writeLatin1(env, v, w, end, &n)) return tooSmall;
+        if (hasForbiddenByte(value, n)) [[unlikely]] {
+            Napi::TypeError::New(env, "Invalid character in response header value").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        w += n;
+
+        if (end - w < 2) return tooSmall;
+        *w++ = '\r';
+        *w++ = '\n';
+    }
+
+    // "Content-Length: " + up to 20 digits + "\r\n\r\n"
+    if (end - w < 16 + 20 + 4) return tooSmall;
+    memcpy(w, "Content-Length: ", 16);
+    w += 16;
+    w += ResponseSerializer::writeDecimal(w, bodyLen);
+    memcpy(w, "\r\n\r\n", 4);
+    w += 4;
+
+    if (bodyData) {
+        if ((size_t)(end - w) < bodyLen) return tooSmall;
+        memcpy(w, bodyData, bodyLen);
+        w += bodyLen;
+    } else if (bodyString) {
+        // +1 for the terminator napi always writes.
+        if ((size_t)(end - w) < bodyLen + 1) return tooSmall;
+        size_t n = 0;
+        napi_get_value_string_utf8(env, body, w, bodyLen + 1, &n);
+        w += n;
+    }
+
+    return Napi::Number::New(env, (double)(w - base));
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <napi.h>
+#include <cstdint>
+
+/// Response head writer behind hypernode.serializeResponse.
+///
+/// Writes "HTTP/1.1 <status line>", the given headers, Content-Length and
+/// the blank line straight into a caller-owned output Buffer, optionally
+/// followed by the body. Nothing is allocated on the native side.
+namespace ResponseSerializer {
+
+    /// Precomputed "HTTP/1.1 <code> <reason>\r\n" for 100..599,
+    /// nullptr for anything else.
+    const char* statusLine(uint32_t status, uint32_t* len);
+
+    /// Writes the decimal form of v to dst, returns the number of digits.
+    uint32_t writeDecimal(char* dst, uint64_t v);
+}
+
+/// serializeResponse(status, headerKeys, headerValues, body, outBuf, headerCount?, staticHeaders?, dateHeader?)
+///
+/// body is a Buffer or string copied behind the head, or a number that only
+/// sets Content-Length (the caller writes the body itself). headerCount
+/// limits the headers to the first n entries of the arrays. staticHeaders is
+/// a route's pre-encoded "Name: value\r\n" block, copied right after the
+/// status line with a single memcpy, after the pre-encoded dateHeader line
+/// when one is given. Returns the
+/// number of bytes written, or -1 when outBuf is too small.
+Napi::Value SerializeResponse(const Napi::CallbackInfo& info);
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <napi.h>
+
+/// Bump allocator over the per-connection scratch Buffer
+/// (ChunkProgression.scratch) for temporary bytes of the native parse path:
+/// lowercased header names, merged header values and decoded query
+/// components. Everything allocated here is copied into a V8 value before
+/// the native call returns, so an arena only lives for one call and is
+/// rewound by constructing it again; no memory is freed.
+///
+/// alloc() returns nullptr when the arena is missing or full, callers then
+/// fall back to a heap std::string.
+class ScratchArena {
+public:
+    ScratchArena() = default;
+    ScratchArena(char* base, size_t capacity) : m_base(base), m_capacity(capacity) {}
+
+    /// Arena over info[arg] if it is a Buffer, empty otherwise.
+    static ScratchArena fromArg(const Napi::CallbackInfo& info, size_t arg) {
+        if (info.Length() > arg && info[arg].IsBuffer()) {
+            auto buf = info[arg].As<Napi::Buffer<char>>();
+            return ScratchArena(buf.Data(), buf.Length());
+        }
+        return ScratchArena();
+    }
+
+    char* alloc(size_t n) {
+        if (n > m_capacity - m_used) return nullptr;
+        char* p = m_base + m_used;
+        m_used += n;
+        return p;
+    }
+
+    size_t mark() const { return m_used; }
+    void rewind(size_t mark) { m_used = mark; }
+
+private:
+    char* m_base = nullptr;
+    size_t m_capacity = 0;
+    size_t m_used = 0;
+};
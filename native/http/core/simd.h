@@ -0,0 +1,145 @@
+#pragma once
+#include <cstdint>
+
+// Shared 128-bit SIMD backend (SSE2 / NEON) used by the header scanner and
+// the route matcher.
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define SIMD_NEON 1
+
+#elif defined(__SSE2__) || defined(__AVX2__) || defined(_M_X64) || defined(_M_AMD64)
+    #define SIMD_SSE2 1
+
+#else
+    #error "No SIMD backend (SSE2/AVX2/NEON required)"
+#endif
+
+#if SIMD_SSE2
+    #include <immintrin.h>
+    using uint128_t = __m128i;
+    static inline __m128i mask128_sse(unsigned n) {
+        static const uint8_t masks[17][16] = {
+            {0},
+            {0xFF},
+            {0xFF,0xFF},
+            {0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+        };
+        return _mm_loadu_si128((const __m128i*)masks[n]);
+    }
+#elif SIMD_NEON
+    #include <arm_neon.h>
+    using uint128_t = uint8x16_t;
+    static inline uint8x16_t mask128_neon(unsigned n) {
+        static const uint8_t table[17][16] = {
+            {0},
+            {0xFF},
+            {0xFF,0xFF},
+            {0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF},
+            {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF}
+        };
+        return vld1q_u8(table[n]);
+    }
+#endif
+
+static inline uint128_t load_u128(const char* p) {
+#if SIMD_SSE2
+    return _mm_loadu_si128((const __m128i*)p);
+#elif SIMD_NEON
+    return vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+#endif
+}
+
+// True if the first n bytes of a and b are equal.
+static inline bool simd_eq_n(
+    uint128_t a, uint128_t b, unsigned n
+) {
+#if SIMD_SSE2
+    __m128i mask = mask128_sse(n);
+    __m128i diff = _mm_xor_si128(a, b);
+    diff = _mm_and_si128(diff, mask);
+    return _mm_movemask_epi8(diff) == 0;
+#elif SIMD_NEON
+    uint8x16_t mask = mask128_neon(n);
+    uint8x16_t diff = veorq_u8(a, b);
+    diff = vandq_u8(diff, mask);
+    return vmaxvq_u8(diff) == 0;
+#endif
+}
+
+// Index of the first of the first n lanes of v equal to c, or -1.
+static inline int simd_find_byte(uint128_t v, uint8_t c, unsigned n) {
+#if SIMD_SSE2
+    __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)c)), mask128_sse(n));
+    unsigned bits = (unsigned)_mm_movemask_epi8(eq);
+    return bits ? __builtin_ctz(bits) : -1;
+#elif SIMD_NEON
+    uint8x16_t eq = vandq_u8(vceqq_u8(v, vdupq_n_u8(c)), mask128_neon(n));
+    // Narrow every lane to 4 bits so the whole mask fits into one u64.
+    uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+    return bits ? (__builtin_ctzll(bits) >> 2) : -1;
+#endif
+}
+
+// Bit i of the result is set when lane i of the comparison result eq is 0xFF.
+static inline uint32_t simd_movemask(uint128_t eq) {
+#if SIMD_SSE2
+    return (uint32_t)_mm_movemask_epi8(eq);
+#elif SIMD_NEON
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t bits = vandq_u8(eq, vld1q_u8(weights));
+    return (uint32_t)vaddv_u8(vget_low_u8(bits)) | ((uint32_t)vaddv_u8(vget_high_u8(bits)) << 8);
+#endif
+}
+
+// Lane mask of v for bytes equal to any of Cs.
+template <char... Cs>
+static inline uint32_t simd_eq_any_mask(uint128_t v) {
+#if SIMD_SSE2
+    __m128i eq = _mm_setzero_si128();
+    ((eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, _mm_set1_epi8(Cs)))), ...);
+#elif SIMD_NEON
+    uint8x16_t eq = vdupq_n_u8(0);
+    ((eq = vorrq_u8(eq, vceqq_u8(v, vdupq_n_u8((uint8_t)Cs)))), ...);
+#endif
+    return simd_movemask(eq);
+}
+
+// First byte of [p, end) equal to any of Cs, or end. 16 bytes per step,
+// never reads past end.
+template <char... Cs>
+static inline const char* simd_find_any(const char* p, const char* end) {
+    while (end - p >= 16) {
+        uint32_t m = simd_eq_any_mask<Cs...>(load_u128(p));
+        if (m) return p + __builtin_ctz(m);
+        p += 16;
+    }
+    for (; p < end; ++p) {
+        if (((*p == Cs) || ...)) return p;
+    }
+    return end;
+}
@@ -1,14 +1,17 @@
 #include "cpool.h"
 #include <iostream>
 #include <stdexcept>
+#include <cstring>
 
 Napi::Function CPool::GetClass(Napi::Env env) {
     return DefineClass(env, "CPool", {
         InstanceMethod("initializePool", &CPool::InitializePool),
         InstanceMethod("registerObj", &CPool::RegisterObj),
+        InstanceMethod("registerMany", &CPool::RegisterMany),
         InstanceMethod("allocate", &CPool::Allocate),
         InstanceMethod("free", &CPool::Free),
         InstanceMethod("resizePool", &CPool::ResizePool),
+        InstanceMethod("sharedState", &CPool::SharedState),
     });
 }
 
@@ -17,6 +20,7 @@ CPool::CPool(const Napi::CallbackInfo& info)
     m_activeSize = 0;
     m_currentSize = 0;
     m_retiredCount = 0;
+    m_registerCursor = 0;
     m_shrinking = false;
 }
 
@@ -25,18 +29,55 @@ CPool::~CPool() {
         if (!e.jsRef.IsEmpty()) e.jsRef.Unref();
     }
     m_poolEntries.clear();
-    m_freeStack.clear();
+    m_sharedRef.Reset();
+    m_shared = nullptr;
 }
 
 inline void CPool::pushFreeIndex(int idx) {
-    m_freeStack.push_back(idx);
+    m_shared[SHARED_HEADER + m_shared[SHARED_FREE_TOP]++] = idx;
 }
 
 inline int CPool::popFreeIndex() {
-    if (m_freeStack.empty()) [[unlikely]] return -1;
-    int idx = m_freeStack.back();
-    m_freeStack.pop_back();
-    return idx;
+    if (m_shared[SHARED_FREE_TOP] == 0) [[unlikely]] return -1;
+    return m_shared[SHARED_HEADER + --m_shared[SHARED_FREE_TOP]];
+}
+
+// Entries only lose their jsRef through a shrink, which moves the cursor
+// back to the first emptied index, so registering a whole pool is O(n).
+inline int CPool::nextRegisterSlot() {
+    while (m_registerCursor < m_currentSize && !m_poolEntries[m_registerCursor].jsRef.IsEmpty()) {
+        ++m_registerCursor;
+    }
+    return m_registerCursor < m_currentSize ? (int)m_registerCursor : -1;
+}
+
+inline void CPool::clearFreeStack() {
+    m_shared[SHARED_FREE_TOP] = 0;
+}
+
+inline void CPool::syncSharedHeader() {
+    m_shared[SHARED_ACTIVE_SIZE] = (int32_t)m_activeSize;
+    m_shared[SHARED_CAPACITY] = (int32_t)m_capacity;
+}
+
+// Grows the shared state to hold n entries. The old ArrayBuffer is only
+// dropped, JS views of it must be refreshed through sharedState().
+void CPool::ensureCapacity(Napi::Env env, size_t n) {
+    if (n <= m_capacity) return;
+
+    Napi::ArrayBuffer buf = Napi::ArrayBuffer::New(env, (SHARED_HEADER + 2 * n) * sizeof(int32_t));
+    int32_t* next = static_cast<int32_t*>(buf.Data());
+    memset(next, 0, buf.ByteLength());
+
+    if (m_shared) {
+        memcpy(next, m_shared, (SHARED_HEADER + (size_t)m_shared[SHARED_FREE_TOP]) * sizeof(int32_t));
+        memcpy(next + SHARED_HEADER + n, m_shared + SHARED_HEADER + m_capacity, m_capacity * sizeof(int32_t));
+    }
+
+    m_sharedRef = Napi::Persistent(buf);
+    m_shared = next;
+    m_capacity = n;
+    syncSharedHeader();
 }
 
 Napi::Value CPool::InitializePool(const Napi::CallbackInfo& info) {
@@ -57,7 +98,7 @@ Napi::Value CPool::InitializePool(const Napi::CallbackInfo& info) {
 
     try {
         m_poolEntries.resize(newSize);
-        m_freeStack.reserve(newSize);
+        ensureCapacity(env, newSize);
     } catch (const std::bad_alloc&) {
         Napi::Error::New(env, "Allocation failed").ThrowAsJavaScriptException();
         return env.Null();
@@ -70,9 +111,10 @@ Napi::Value CPool::InitializePool(const Napi::CallbackInfo& info) {
 
     // Initially all slots are free for registration and allocation.
     for (size_t i = 0; i < (size_t)newSize; ++i) {
-        m_poolEntries[i].inUse = false;
+        inUse(i) = 0;
         pushFreeIndex((int)i);
     }
+    syncSharedHeader();
 
     return env.Undefined();
 }
@@ -88,14 +130,8 @@ Napi::Value CPool::RegisterObj(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    // Find an index that currently has no jsRef assigned.
-    int found = -1;
-    for (size_t i = 0; i < m_currentSize; ++i) {
-        if (m_poolEntries[i].jsRef.IsEmpty()) {
-            found = (int)i;
-            break;
-        }
-    }
+    // First index that currently has no jsRef assigned.
+    int found = nextRegisterSlot();
     if (found == -1) {
         Napi::Error::New(env, "No free registration slot").ThrowAsJavaScriptException();
         return env.Null();
@@ -109,6 +145,50 @@ Napi::Value CPool::RegisterObj(const Napi::CallbackInfo& info) {
     return Napi::Number::New(env, found);
 }
 
+Napi::Value CPool::RegisterMany(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "RegisterMany expects an array of objects").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (m_currentSize == 0) {
+        Napi::Error::New(env, "Pool not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Array objs = info[0].As<Napi::Array>();
+    uint32_t n = objs.Length();
+
+    // Validate first so a bad element registers nothing.
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!objs.Get(i).IsObject()) {
+            Napi::TypeError::New(env, "RegisterMany expects an array of objects").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+
+    // Count the free slots as well, a pool without room for every object
+    // registers none of them. Slots below the cursor are all taken.
+    int first = nextRegisterSlot();
+    uint32_t vacant = 0;
+    for (size_t i = first == -1 ? m_currentSize : (size_t)first; i < m_currentSize && vacant < n; ++i) {
+        if (m_poolEntries[i].jsRef.IsEmpty()) ++vacant;
+    }
+    if (vacant < n) {
+        Napi::Error::New(env, "No free registration slot").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Int32Array ids = Napi::Int32Array::New(env, n);
+    for (uint32_t i = 0; i < n; ++i) {
+        int found = nextRegisterSlot();
+        m_poolEntries[found].jsRef = Napi::Persistent(objs.Get(i).As<Napi::Object>());
+        ids[i] = found;
+    }
+
+    return ids;
+}
+
 Napi::Value CPool::Allocate(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
@@ -131,7 +211,7 @@ Napi::Value CPool::Allocate(const Napi::CallbackInfo& info) {
     }
 
     PoolEntry& entry = m_poolEntries[idx];
-    entry.inUse = true;
+    inUse(idx) = 1;
 
     // Return the JS object or null if not registered
     if (entry.jsRef.IsEmpty()) [[likely]] {
@@ -155,12 +235,12 @@ Napi::Value CPool::Free(const Napi::CallbackInfo& info) {
     }
 
     PoolEntry& entry = m_poolEntries[idx];
-    if (!entry.inUse) [[unlikely]] {
+    if (!inUse(idx)) [[unlikely]] {
         // double free - ignore silently (or optionally log)
         return env.Undefined();
     }
 
-    entry.inUse = false;
+    inUse(idx) = 0;
 
     // If this index is in retired area, we must Unref the jsRef and decrease retired count.
     if ((size_t)idx >= m_activeSize) [[unlikely]] {
@@ -168,6 +248,7 @@ Napi::Value CPool::Free(const Napi::CallbackInfo& info) {
         if (!entry.jsRef.IsEmpty()) {
             entry.jsRef.Unref();
             entry.jsRef = Napi::ObjectReference();
+            if ((size_t)idx < m_registerCursor) m_registerCursor = (size_t)idx;
         }
         if (m_retiredCount > 0) {
             --m_retiredCount;
@@ -196,13 +277,14 @@ void CPool::finalizeShrinkIfNeeded(Napi::Env env) {
     }
     m_poolEntries.resize(m_activeSize);
     m_currentSize = m_activeSize;
+    if (m_registerCursor > m_currentSize) m_registerCursor = m_currentSize;
     // rebuild freeStack to contain only indices < activeSize that are free
-    m_freeStack.clear();
-    m_freeStack.reserve(m_activeSize);
+    clearFreeStack();
     for (size_t i = 0; i < m_activeSize; ++i) {
-        if (!m_poolEntries[i].inUse) pushFreeIndex((int)i);
+        if (!inUse(i)) pushFreeIndex((int)i);
     }
     m_shrinking = false;
+    syncSharedHeader();
 }
 
 Napi::Value CPool::ResizePool(const Napi::CallbackInfo& info) {
@@ -223,9 +305,10 @@ Napi::Value CPool::ResizePool(const Napi::CallbackInfo& info) {
         try {
             size_t old = m_currentSize;
             m_poolEntries.resize(newSize);
+            ensureCapacity(env, newSize);
             // initialize new slots as free and push them to freeStack if they are within active area
             for (size_t i = old; i < newSize; ++i) {
-                m_poolEntries[i].inUse = false;
+                inUse(i) = 0;
             }
             // add new indices to freeStack for the extended active area
             for (size_t i = old; i < newSize; ++i) {
@@ -233,6 +316,7 @@ Napi::Value CPool::ResizePool(const Napi::CallbackInfo& info) {
             }
             m_currentSize = newSize;
             m_activeSize = newSize;
+            syncSharedHeader();
         } catch (const std::bad_alloc&) {
             Napi::Error::New(env, "allocation failed").ThrowAsJavaScriptException();
             return env.Null();
@@ -242,10 +326,11 @@ Napi::Value CPool::ResizePool(const Napi::CallbackInfo& info) {
         size_t retiredStart = newSize;
         size_t activeInRetired = 0;
         for (size_t i = retiredStart; i < m_currentSize; ++i) {
-            if (m_poolEntries[i].inUse) activeInRetired++;
+            if (inUse(i)) activeInRetired++;
         }
 
         m_activeSize = newSize;
+        syncSharedHeader();
 
         if (activeInRetired == 0) {
             // safe to immediately shrink: unref jsRefs and resize
@@ -257,26 +342,35 @@ Napi::Value CPool::ResizePool(const Napi::CallbackInfo& info) {
             }
             m_poolEntries.resize(m_activeSize);
             m_currentSize = m_activeSize;
+            if (m_registerCursor > m_currentSize) m_registerCursor = m_currentSize;
             // rebuild freeStack
-            m_freeStack.clear();
-            m_freeStack.reserve(m_activeSize);
+            clearFreeStack();
             for (size_t i = 0; i < m_activeSize; ++i) {
-                if (!m_poolEntries[i].inUse) pushFreeIndex((int)i);
+                if (!inUse(i)) pushFreeIndex((int)i);
             }
         } else {
             // there are active entries in retired area -> mark for shrink
             m_retiredCount = activeInRetired;
             m_shrinking = true;
             // remove retired indices from freeStack if any (they shouldn't be free)
-            std::vector<int> newStack;
-            newStack.reserve(m_freeStack.size());
-            for (int idx : m_freeStack) {
-                if ((size_t)idx < m_activeSize) newStack.push_back(idx);
+            int32_t* stack = m_shared + SHARED_HEADER;
+            int32_t kept = 0;
+            for (int32_t i = 0; i < m_shared[SHARED_FREE_TOP]; ++i) {
+                if ((size_t)stack[i] < m_activeSize) stack[kept++] = stack[i];
             }
-            m_freeStack.swap(newStack);
+            m_shared[SHARED_FREE_TOP] = kept;
             // retired indices remain until freed; when freed, Free() will decrement m_retiredCount and finalize
         }
     }
 
     return env.Undefined();
 }
+
+Napi::Value CPool::SharedState(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (m_currentSize == 0) {
+        Napi::Error::New(env, "Pool not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return Napi::Int32Array::New(env, SHARED_HEADER + 2 * m_capacity, m_sharedRef.Value(), 0);
+}
@@ -6,10 +6,20 @@
 
 struct PoolEntry {
     Napi::ObjectReference jsRef; // persistent JS object
-    bool inUse = false;          // true when allocated
     // optionally other meta fields...
 };
 
+// Layout of the Int32Array returned by sharedState(). The free stack and
+// the in-use flags live in it so JS can allocate and free without a native
+// call (ts/http/context/SharedCPool.ts); resize/shrink stays native.
+// Must stay in the same order as SharedSlot in SharedCPool.ts.
+enum SharedSlot : int32_t {
+    SHARED_FREE_TOP,     // number of entries on the free stack
+    SHARED_ACTIVE_SIZE,  // indices >= this are retired
+    SHARED_CAPACITY,     // length of the free stack and in-use regions
+    SHARED_HEADER        // free stack starts here, in-use flags follow it
+};
+
 class CPool : public Napi::ObjectWrap<CPool> {
 public:
     static Napi::Function GetClass(Napi::Env env);
@@ -19,21 +29,31 @@ public:
     // NAPI methods
     Napi::Value InitializePool(const Napi::CallbackInfo& info);
     Napi::Value RegisterObj(const Napi::CallbackInfo& info);
+    Napi::Value RegisterMany(const Napi::CallbackInfo& info);
     Napi::Value Allocate(const Napi::CallbackInfo& info);
     Napi::Value Free(const Napi::CallbackInfo& info);
     Napi::Value ResizePool(const Napi::CallbackInfo& info);
+    Napi::Value SharedState(const Napi::CallbackInfo& info);
 
 private:
     // core data
     std::vector<PoolEntry> m_poolEntries;
-    std::vector<int> m_freeStack;          // indices of free entries (LIFO)
+    Napi::Reference<Napi::ArrayBuffer> m_sharedRef; // shared state, see SharedSlot
+    int32_t* m_shared = nullptr;
+    size_t m_capacity = 0;                 // free stack / in-use region length
     size_t m_activeSize = 0;               // visible active capacity
     size_t m_currentSize = 0;              // physical vector size
     size_t m_retiredCount = 0;             // number of in-use entries in retired zone
+    size_t m_registerCursor = 0;           // every entry below it has a jsRef
     bool m_shrinking = false;              // indicates shrink process in progress
 
     // helpers
     void pushFreeIndex(int idx);
     int popFreeIndex();                    // -1 if none
+    void clearFreeStack();
+    int nextRegisterSlot();                // -1 if every entry has a jsRef
+    int32_t& inUse(size_t idx) { return m_shared[SHARED_HEADER + m_capacity + idx]; }
+    void ensureCapacity(Napi::Env env, size_t n);
+    void syncSharedHeader();
     void finalizeShrinkIfNeeded(Napi::Env env);
 };
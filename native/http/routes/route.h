@@ -2,11 +2,15 @@
 #include <cstdint>
 #include <vector>
 #include <napi.h>
+#include <scratch_arena.h>
 
 using namespace std;
 
 namespace RouteBuilder {
     enum ParamType { kString = 1, kNumber = 2 };
+
+    /// Longest digit run accepted for a kNumber param (below 2^53).
+    constexpr size_t kMaxNumberParamDigits = 15;
     /// Endpoint parameter metadata.
     struct EndpointParam {
         std::string name;
@@ -29,8 +33,8 @@ namespace RouteBuilder {
     /// 'cold' data: small fixed-size fields come first for cache locality.
     struct alignas(64) RouteNode {
         // HOT data
-        uint64_t value = 0; ///< Packed up to 8 characters for fast comparison
-        size_t value_length = 0; ///< Number of meaningful bytes in `value`
+        uint64_t value = 0; ///< First (up to) 8 characters packed for fast comparison
+        size_t value_length = 0; ///< Length of the static run, may exceed 8
         int vptr_table_index = -1; ///< Handler index if this node terminates an endpoint
         ParamType param_type = ParamType::kString;
         char _padding[7] = {};
@@ -40,6 +44,7 @@ namespace RouteBuilder {
 
         // COLD data
         std::string param_name; ///< Name of the parameter (if is_param)
+        std::string segment; ///< Full static run (static nodes only)
         std::vector<std::shared_ptr<RouteNode>> children;///< Child nodes
         std::weak_ptr<RouteNode> parent; ///< Optional parent pointer
     };
@@ -48,6 +53,117 @@ namespace RouteBuilder {
     // static_assert(sizeof(RouteNode) % 64 == 0, "RouteNode must be 64-byte aligned multiple");
 
 
+    enum FlatNodeKind : uint8_t { kStatic = 0, kParam = 1, kWildcard = 2 };
+
+    /// Frozen route node. Only hot fields, no pointers: the children of a node
+    /// are the contiguous range [first_child, first_child + child_count) of
+    /// RouteTable::nodes, in the same order as RouteNode::children.
+    struct FlatRouteNode {
+        uint64_t value = 0; ///< First (up to) 8 characters packed for fast comparison
+        uint32_t first_child = 0; ///< Index of the first child in RouteTable::nodes
+        int32_t vptr_table_index = -1; ///< Handler index if this node terminates an endpoint
+        uint32_t keys_offset = 0; ///< First-byte key block in RouteTable::keys (wide nodes only)
+        uint16_t child_count = 0;
+        uint16_t static_count = 0; ///< Leading static children, each with a distinct first byte
+        uint16_t value_length = 0; ///< Length of the static run
+        uint8_t kind = kStatic; ///< FlatNodeKind
+        uint8_t param_type = ParamType::kString;
+        uint32_t run_offset = 0; ///< Full run in RouteTable::runs when value_length > 8
+    };
+
+    static_assert(sizeof(FlatRouteNode) == 32, "FlatRouteNode must stay 32 bytes");
+
+    /// Nodes with at least this many static children select the child by a
+    /// SIMD compare over their first-byte key block instead of a linear scan.
+    constexpr uint16_t kWideFanout = 4;
+
+    /// Numeric param segments matchUrl can rewind per request, see matchUrl.
+    constexpr uint32_t kMaxParamChoices = 16;
+
+    /// Longest static run a single node may hold (FlatRouteNode::value_length).
+    constexpr size_t kMaxRun = 0xFFFF;
+
+    /// Contiguous, breadth-first node array produced by freezeRouteTree.
+    /// nodes[0] is the root.
+    struct RouteTable {
+        std::vector<FlatRouteNode> nodes;
+        /// First bytes of the static children of wide nodes, one 16-byte
+        /// padded block per node, addressed by FlatRouteNode::keys_offset.
+        std::vector<uint8_t> keys;
+        /// Static runs longer than 8 bytes, back to back, followed by 16 bytes
+        /// of padding so every 16-byte load stays inside the pool.
+        std::vector<char> runs;
+
+        explicit operator bool() const {
+            return !nodes.empty();
+        }
+    };
+
+
+    /// Query output of the matchers. With `params` set the query is decoded
+    /// eagerly into it, otherwise only its span (relative to the URL buffer,
+    /// without the '?') is recorded and decoded later through parseQuery.
+    struct QueryOut {
+        Napi::Object* params = nullptr;
+        uint32_t start = 0;
+        uint32_t len = 0;
+        ScratchArena* scratch = nullptr; ///< Decode buffer for eager mode, optional
+    };
+
+    /// Slot of the static route hash. len == 0 marks an empty slot.
+    struct StaticRouteSlot {
+        uint32_t path_offset = 0; ///< Path bytes in StaticRouteTable::paths
+        uint16_t len = 0;
+        int32_t vptr_table_index = -1;
+    };
+
+    /// Perfect hash of the fully static endpoints of one method (no ':' and
+    /// no '*'), keyed on the exact path. Two levels (hash and displace):
+    /// the path hash picks a bucket, the bucket's displacement picks the
+    /// slot. Displacements are searched at registration so every path gets
+    /// its own slot in a table of about 2n slots, and a lookup is one hash,
+    /// two loads and one memcmp.
+    struct StaticRouteTable {
+        std::vector<StaticRouteSlot> slots; ///< Power-of-two sized
+        std::vector<uint32_t> displace;     ///< Per bucket, power-of-two sized
+        std::vector<char> paths;
+        uint32_t seed = 0;
+        uint32_t mask = 0;        ///< slots.size() - 1
+        uint32_t bucket_mask = 0; ///< displace.size() - 1
+        uint32_t max_len = 0; ///< Longest static path, bounds the lookup scan
+
+        explicit operator bool() const {
+            return !slots.empty();
+        }
+    };
+
+    /// More static routes than this per method are left to the route trie.
+    constexpr size_t kMaxStaticRoutes = 1 << 16;
+
+    /// Seeded FNV-1a over a path. matchStaticUrl computes the same hash
+    /// incrementally while it looks for the end of the request path.
+    inline uint32_t staticRouteHash(const char* p, size_t len, uint32_t seed) noexcept {
+        uint32_t h = 2166136261u ^ seed;
+        for (size_t i = 0; i < len; ++i) {
+            h ^= static_cast<uint8_t>(p[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    /// Slot of a path hash under its bucket's displacement (murmur3 fmix32,
+    /// so each displacement spreads the bucket's paths independently).
+    inline uint32_t staticRouteSlot(uint32_t h, uint32_t displacement) noexcept {
+        h ^= displacement;
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+
     // Public API
 
 
@@ -61,23 +177,80 @@ namespace RouteBuilder {
 
 
     /**
-    * @brief Match a URL against a previously-built route tree.
+    * @brief Freeze a built route tree into a flat, pointer-free node table.
+    *
+    * The tree itself is left untouched and may be kept for debug printing.
+    * Returns an empty table if root is nullptr.
+    */
+    RouteTable freezeRouteTree(const std::shared_ptr<RouteNode>& root) noexcept;
+
+
+    /**
+    * @brief Build the static route hash from the fully static endpoints in eps.
     *
-    * The returned unique_ptr holds the match result. Use vptr_table_index to
-    * dispatch to the appropriate handler.
+    * Endpoints with params or wildcards are ignored. Returns an empty table,
+    * leaving every path to the route trie, if there is none, if there are
+    * more than kMaxStaticRoutes or if no displacement set was found.
+    */
+    StaticRouteTable buildStaticRouteTable(const std::vector<Endpoint>& eps) noexcept;
+
+
+    /**
+    * @brief Look up the request path in the static route hash.
+    *
+    * On a hit the query (if any) is parsed exactly like matchUrl does and the
+    * vptr_table_index is returned. Returns -1 on a miss (offset untouched, the
+    * caller falls back to matchUrl) or -2 if the query limit was exceeded.
+    */
+    int matchStaticUrl(
+    Napi::Env env,
+    const StaticRouteTable& table,
+    const char* url,
+    size_t urlLen,
+    uint32_t* offset,
+    QueryOut* queryParams,
+    uint32_t query_limit
+    ) noexcept;
+
+
+    /**
+    * @brief Match a URL against a frozen route table.
+    *
+    * Static children commit to the first one that matches. A numeric param
+    * that takes a segment does not: if nothing below it matches, the same
+    * segment is retried with its string param or wildcard sibling, so
+    * `/tags/:id(int)/x` and `/tags/:name/y` both serve `/tags/12/...`. Only
+    * the first kMaxParamChoices such segments of a URL can be rewound.
+    *
+    * Returns the vptr_table_index of the matched endpoint, -1 if nothing
+    * matched, -2 if the query limit was exceeded or -3 if the URL was too long.
     */
     int matchUrl(
     Napi::Env env,
-    const std::shared_ptr<RouteNode>& root,
+    const RouteTable& table,
     const char* url,
     size_t urlLen,
     uint32_t* offset,
     Napi::Array* pathParams,
-    Napi::Object* queryParams,
+    QueryOut* queryParams,
     uint32_t query_limit
     ) noexcept;
 
 
+    /**
+    * @brief Decode the '&'-separated pairs of a recorded query span into
+    * queryParams (deferred query mode). Percent-decoding uses scratch when
+    * given, the heap otherwise.
+    */
+    void parseQuery(
+    Napi::Env env,
+    const char* query,
+    size_t len,
+    Napi::Object* queryParams,
+    ScratchArena* scratch = nullptr
+    ) noexcept;
+
+
     /**
     * @brief Debug helper: print the route tree (human-readable).
     */
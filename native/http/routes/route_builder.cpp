@@ -5,7 +5,10 @@
 #include "route.h"
 
 #include <algorithm>
+#include <cstring>
+#include <deque>
 #include <map>
+#include <new>
 #include <string>
 
 using namespace RouteBuilder;
@@ -14,7 +17,6 @@ namespace {
 
     constexpr char kParamMarker = ':'; ///< marker for parameters in the pattern
     constexpr char kWildcardMarker = '*'; ///< marker for wildcard all path names in the pattern
-    constexpr int kMaxPacked = 8; ///< maximum bytes to pack into a u64 for comparison
 
     // Pack up to 8 bytes from `str` into a u64. If len < 8, fill high bytes with 0xFF
     // to maintain inequality for short vs longer sequences.
@@ -54,6 +56,16 @@ namespace {
         return n;
     }
 
+    // Metadata of the param whose marker sits at `offset` in ep.url, i.e.
+    // the n-th param where n is the number of markers before it.
+    static const EndpointParam* paramAt(const Endpoint& ep, int offset) {
+        size_t index = 0;
+        for (int i = 0; i < offset; ++i) {
+            if (ep.url[i] == kParamMarker) ++index;
+        }
+        return index < ep.params.size() ? &ep.params[index] : nullptr;
+    }
+
     // offset -> index into the url char array
     static void buildSubRouteTree(std::shared_ptr<RouteNode> node, const std::vector<Endpoint>& eps, int offset) {
         if (!node) return;
@@ -81,11 +93,12 @@ namespace {
             else static_eps.push_back(ep);
         }
 
-        // 3) Handle static prefix group (build common prefix up to MAX_VALUE_EXP)
+        // 3) Handle static prefix group (build the whole common prefix, runs
+        //    longer than 8 bytes are compared from RouteTable::runs)
         if (!static_eps.empty()) {
             // Build common prefix character-by-character
             std::string prefix;
-            for (int p = 0; p < kMaxPacked; ++p) {
+            for (size_t p = 0; p < kMaxRun; ++p) {
                 char ch = static_eps[0].url[offset + p];
                 if (ch == '\0' || ch == kParamMarker || ch == kWildcardMarker) break;
 
@@ -101,6 +114,7 @@ namespace {
                 auto static_node = makeStaticNode();
                 static_node->value_length = static_cast<size_t>(prefix.size());
                 static_node->value = packU64Safe(prefix.c_str(), static_node->value_length);
+                static_node->segment = prefix;
                 node->children.push_back(static_node);
 
                 // recursion on static group with advanced offset
@@ -119,24 +133,37 @@ namespace {
                     auto child = makeStaticNode();
                     child->value_length = 1;
                     child->value = packU64Safe(onechar.c_str(), 1);
+                    child->segment = onechar;
                     node->children.push_back(child);
                     buildSubRouteTree(child, kv.second, offset + 1);
                 }
             }
         }
 
-        // 4) Handle param group (there should be at most one param child, but if multiple different param names,
-        //    we might need to disambiguate; here we take the first's metadata)
+        // 4) Handle param group: one param child per declared type. Numeric
+        //    params come first; matchUrl hands the string sibling every
+        //    segment they reject, and rewinds to it when a numeric segment
+        //    dead-ends further down. Names are taken from the first endpoint
+        //    of each group.
         if (!param_eps.empty()) {
-            auto param_node = makeParamNode();
-            // Use the first endpoint's param meta
-            if (!param_eps[0].params.empty()) {
-                param_node->param_name = param_eps[0].params[0].name;
-                param_node->param_type = param_eps[0].params[0].type;
+            std::vector<Endpoint> typed_eps[2]; // [0] kNumber, [1] kString
+            for (auto &ep : param_eps) {
+                const EndpointParam* meta = paramAt(ep, offset);
+                typed_eps[(meta && meta->type == ParamType::kNumber) ? 0 : 1].push_back(ep);
+            }
+
+            for (auto &group : typed_eps) {
+                if (group.empty()) continue;
+
+                auto param_node = makeParamNode();
+                if (const EndpointParam* meta = paramAt(group[0], offset)) {
+                    param_node->param_name = meta->name;
+                    param_node->param_type = meta->type;
+                }
+                node->children.push_back(param_node);
+                // skip the ":/" marker -> offset + 2
+                buildSubRouteTree(param_node, group, offset + 2);
             }
-            node->children.push_back(param_node);
-            // skip the ":/" marker -> offset + 2
-            buildSubRouteTree(param_node, param_eps, offset + 2);
         }
 
         // 5) Wildcard route (terminal matcher)
@@ -159,3 +186,180 @@ std::shared_ptr<RouteNode> RouteBuilder::buildRouteTree(const std::vector<Endpoi
     buildSubRouteTree(root, eps, 0);
     return root;
 }
+
+RouteTable RouteBuilder::freezeRouteTree(const std::shared_ptr<RouteNode>& root) noexcept {
+    RouteTable table;
+    if (!root) return table;
+
+    // Breadth-first lowering: every node's children are appended as one
+    // contiguous run, so a level is scanned without leaving the array.
+    std::deque<std::pair<const RouteNode*, uint32_t>> queue;
+    table.nodes.emplace_back();
+    queue.emplace_back(root.get(), 0);
+
+    while (!queue.empty()) {
+        auto [node, index] = queue.front();
+        queue.pop_front();
+
+        FlatRouteNode& flat = table.nodes[index];
+        flat.value = node->value;
+        flat.value_length = static_cast<uint16_t>(node->value_length);
+        if (node->value_length > 8) {
+            flat.run_offset = static_cast<uint32_t>(table.runs.size());
+            table.runs.insert(table.runs.end(), node->segment.begin(), node->segment.end());
+        }
+        flat.vptr_table_index = node->vptr_table_index;
+        flat.param_type = static_cast<uint8_t>(node->param_type);
+        flat.kind = node->is_param ? kParam : (node->is_wildcard ? kWildcard : kStatic);
+
+        uint32_t first = static_cast<uint32_t>(table.nodes.size());
+        uint16_t count = 0;
+        uint16_t static_count = 0;
+        for (auto &child : node->children) {
+            if (!child) continue;
+            queue.emplace_back(child.get(), first + count);
+            if (!child->is_param && !child->is_wildcard && static_count == count) ++static_count;
+            ++count;
+        }
+
+        table.nodes[index].first_child = first;
+        table.nodes[index].child_count = count;
+        table.nodes[index].static_count = static_count;
+        table.nodes.resize(first + count);
+
+        // Static siblings never share a first byte (buildSubRouteTree either
+        // emits one common-prefix child or buckets by first char), so the
+        // first byte alone picks the only candidate.
+        if (static_count >= kWideFanout) {
+            size_t block = (static_count + 15) & ~size_t(15);
+            table.nodes[index].keys_offset = static_cast<uint32_t>(table.keys.size());
+            table.keys.resize(table.keys.size() + block, 0);
+
+            uint8_t* keys = table.keys.data() + table.nodes[index].keys_offset;
+            uint16_t k = 0;
+            for (auto &child : node->children) {
+                if (!child) continue;
+                if (k == static_count) break;
+                keys[k++] = static_cast<uint8_t>(child->value & 0xFF);
+            }
+        }
+    }
+
+    table.runs.resize(table.runs.size() + 16, 0);
+    table.nodes.shrink_to_fit();
+    return table;
+}
+
+namespace {
+
+    /// Seeds tried for the bucket hash before giving up on the table.
+    constexpr uint32_t kStaticSeedTries = 8;
+    /// Displacements tried per bucket before a seed is given up.
+    constexpr uint32_t kMaxDisplacement = 1u << 16;
+
+    /// Hash and displace: paths are spread over about n/4 buckets, then the
+    /// buckets are placed biggest first, each with the first displacement
+    /// that puts all of its paths into free, distinct slots. With the table
+    /// at most half full that takes a few tries per bucket. Returns an empty
+    /// table if no seed works, e.g. for paths with the same 32-bit hash.
+    StaticRouteTable buildDisplacedTable(const std::map<std::string, int>& statics) {
+        StaticRouteTable table;
+
+        std::vector<const std::pair<const std::string, int>*> keys;
+        keys.reserve(statics.size());
+        for (auto &kv : statics) keys.push_back(&kv);
+        const size_t n = keys.size();
+
+        size_t size = 4;
+        while (size < n * 2) size <<= 1;
+        size_t buckets = 1;
+        while (buckets * 4 < n) buckets <<= 1;
+        const uint32_t mask = static_cast<uint32_t>(size - 1);
+        const uint32_t bucket_mask = static_cast<uint32_t>(buckets - 1);
+
+        std::vector<uint32_t> hashes(n);
+        std::vector<std::vector<uint32_t>> members(buckets);
+        std::vector<uint32_t> order(buckets);
+        std::vector<uint32_t> displace(buckets);
+        std::vector<uint8_t> used(size);
+        std::vector<uint32_t> picked;
+
+        for (uint32_t seed = 1; seed <= kStaticSeedTries; ++seed) {
+            for (auto &m : members) m.clear();
+            for (uint32_t i = 0; i < n; ++i) {
+                hashes[i] = staticRouteHash(keys[i]->first.data(), keys[i]->first.size(), seed);
+                members[hashes[i] & bucket_mask].push_back(i);
+            }
+
+            for (uint32_t b = 0; b < buckets; ++b) order[b] = b;
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return members[a].size() > members[b].size();
+            });
+            std::fill(used.begin(), used.end(), 0);
+            std::fill(displace.begin(), displace.end(), 0);
+
+            bool placed = true;
+            for (uint32_t b : order) {
+                const auto &m = members[b];
+                if (m.empty()) break;
+
+                uint32_t d = 0;
+                for (; d < kMaxDisplacement; ++d) {
+                    picked.clear();
+                    bool fits = true;
+                    for (uint32_t i : m) {
+                        uint32_t slot = staticRouteSlot(hashes[i], d) & mask;
+                        if (used[slot] || std::find(picked.begin(), picked.end(), slot) != picked.end()) {
+                            fits = false;
+                            break;
+                        }
+                        picked.push_back(slot);
+                    }
+                    if (fits) break;
+                }
+                if (d == kMaxDisplacement) { placed = false; break; }
+
+                for (uint32_t slot : picked) used[slot] = 1;
+                displace[b] = d;
+            }
+            if (!placed) continue;
+
+            table.slots.assign(size, StaticRouteSlot());
+            for (uint32_t i = 0; i < n; ++i) {
+                const std::string &path = keys[i]->first;
+                StaticRouteSlot &slot = table.slots[staticRouteSlot(hashes[i], displace[hashes[i] & bucket_mask]) & mask];
+                slot.path_offset = static_cast<uint32_t>(table.paths.size());
+                slot.len = static_cast<uint16_t>(path.size());
+                slot.vptr_table_index = keys[i]->second;
+                table.paths.insert(table.paths.end(), path.begin(), path.end());
+                if (path.size() > table.max_len) table.max_len = static_cast<uint32_t>(path.size());
+            }
+            table.displace = std::move(displace);
+            table.seed = seed;
+            table.mask = mask;
+            table.bucket_mask = bucket_mask;
+            return table;
+        }
+
+        return table;
+    }
+}
+
+StaticRouteTable RouteBuilder::buildStaticRouteTable(const std::vector<Endpoint>& eps) noexcept {
+    // Last registration wins on duplicates, same as buildSubRouteTree.
+    std::map<std::string, int> statics;
+    for (auto &ep : eps) {
+        size_t len = std::strlen(ep.url);
+        if (len == 0 || len > kMaxRun) continue;
+        if (std::memchr(ep.url, kParamMarker, len) || std::memchr(ep.url, kWildcardMarker, len)) continue;
+        statics[std::string(ep.url, len)] = ep.vptr_table_index;
+    }
+    if (statics.empty() || statics.size() > kMaxStaticRoutes) return StaticRouteTable();
+
+    try {
+        return buildDisplacedTable(statics);
+    } catch (const std::bad_alloc&) {
+        // The trie still serves every path.
+        return StaticRouteTable();
+    }
+}
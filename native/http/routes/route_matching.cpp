@@ -3,6 +3,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "route.h"
+#include "simd.h"
 
 #include <cassert>
 #include <cstring>
@@ -49,109 +50,233 @@ namespace {
         return value;
     }
 
-    inline static bool nodeStaticMatches(const std::shared_ptr<RouteNode>& node,
+    // Compare a static run longer than 8 bytes, 16 bytes at a time. URL-side
+    // loads never cross urlLen, the run pool is padded by 16 bytes.
+    inline static bool runMatches(const char* __restrict run,
+                                  const char* __restrict url,
+                                  size_t urlLen,
+                                  uint32_t start,
+                                  size_t len) {
+        if (start + len > urlLen) return false;
+
+        const char* p = url + start;
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16) {
+            if (!simd_eq_n(load_u128(p + i), load_u128(run + i), 16)) return false;
+        }
+
+        size_t tail = len - i;
+        if (tail == 0) return true;
+        if (start + i + 16 <= urlLen) {
+            return simd_eq_n(load_u128(p + i), load_u128(run + i), static_cast<unsigned>(tail));
+        }
+        return std::memcmp(p + i, run + i, tail) == 0;
+    }
+
+    inline static bool nodeStaticMatches(const RouteTable& table,
+                                                     const FlatRouteNode& node,
                                                      const char* __restrict url,
+                                                     size_t urlLen,
                                                      uint32_t* offset) {
-        uint64_t value_buffer = packedU64FromString(url, *offset, *offset + node->value_length);
+        uint64_t value_buffer = packedU64FromString(url, *offset, *offset + node.value_length);
+
+        if (value_buffer != node.value) return false;
+        if (node.value_length <= 8) [[likely]] return true;
 
-        return (value_buffer == node->value);
+        return runMatches(table.runs.data() + node.run_offset, url, urlLen, *offset, node.value_length);
     }
 
-    inline static constexpr char hex_to_char(char h) noexcept {
-        return (h >= '0' && h <= '9') ? (h - '0')
-             : (h >= 'A' && h <= 'F') ? (h - 'A' + 10)
-             : (h >= 'a' && h <= 'f') ? (h - 'a' + 10)
-             : 0;
+    // Parse a `:name(int)` segment: 1 to kMaxNumberParamDigits ASCII digits,
+    // so the value always fits a JS number exactly.
+    inline static bool parseNumberParam(const char* p, size_t len, uint64_t* out) {
+        if (len == 0 || len > kMaxNumberParamDigits) return false;
+
+        uint64_t v = 0;
+        for (size_t i = 0; i < len; ++i) {
+            uint8_t d = static_cast<uint8_t>(p[i] - '0');
+            if (d > 9) return false;
+            v = v * 10 + d;
+        }
+        *out = v;
+        return true;
     }
 
-    inline static std::string url_decode(const char* __restrict start, const char* __restrict end) {
-        std::string out;
-        out.reserve(end - start);
+    // Index of the static child of a wide node whose first byte is c, or -1.
+    inline static int selectStaticChild(const RouteTable& table, const FlatRouteNode& node, uint8_t c) {
+        const char* keys = reinterpret_cast<const char*>(table.keys.data() + node.keys_offset);
+
+        for (unsigned base = 0; base < node.static_count; base += 16) {
+            unsigned n = node.static_count - base;
+            if (n > 16) n = 16;
+
+            int idx = simd_find_byte(load_u128(keys + base), c, n);
+            if (idx >= 0) return static_cast<int>(base) + idx;
+        }
+        return -1;
+    }
+
+    // Hex digit values for %XX decoding, non-hex bytes decode as 0.
+    struct HexTable {
+        uint8_t v[256] = {};
+        constexpr HexTable() {
+            for (int c = '0'; c <= '9'; ++c) v[c] = static_cast<uint8_t>(c - '0');
+            for (int c = 'A'; c <= 'F'; ++c) v[c] = static_cast<uint8_t>(c - 'A' + 10);
+            for (int c = 'a'; c <= 'f'; ++c) v[c] = static_cast<uint8_t>(c - 'a' + 10);
+        }
+    };
+    constexpr HexTable kHex{};
+
+    // Percent-decode [start, end) into dst, which has room for end - start
+    // bytes, copying the runs between escapes in bulk. Returns the length.
+    inline static size_t url_decode_into(char* __restrict dst, const char* __restrict p, const char* __restrict end) {
+        char* out = dst;
 
-        const char* p = start;
         while (p < end) {
-            char c = *p;
-            if (c == '%') {
-                if (p + 2 < end) {
-                    char hi = hex_to_char(*(p + 1));
-                    char lo = hex_to_char(*(p + 2));
-                    out.push_back((hi << 4) | lo);
-                    p += 3;
-                    continue;
-                }
-            } else if (c == '+') {
-                out.push_back(' ');
+            const char* run = simd_find_any<'%', '+'>(p, end);
+            std::memcpy(out, p, run - p);
+            out += run - p;
+            p = run;
+            if (p == end) break;
+
+            if (*p == '%' && p + 2 < end) {
+                uint8_t hi = kHex.v[static_cast<uint8_t>(p[1])];
+                uint8_t lo = kHex.v[static_cast<uint8_t>(p[2])];
+                *out++ = static_cast<char>((hi << 4) | lo);
+                p += 3;
+            } else {
+                *out++ = *p == '+' ? ' ' : *p;
                 ++p;
-                continue;
             }
+        }
+        return static_cast<size_t>(out - dst);
+    }
 
-            out.push_back(c);
-            ++p;
+    // Decode one query component straight into a V8 string. Components
+    // without '%' or '+' are handed over as-is. The others are decoded into
+    // the scratch arena, or a reused heap buffer without one.
+    inline static Napi::String url_decode(
+        Napi::Env env, ScratchArena* scratch,
+        const char* __restrict start, const char* __restrict end
+    ) {
+        const char* p = simd_find_any<'%', '+'>(start, end);
+        if (p == end) return Napi::String::New(env, start, end - start);
+
+        size_t cap = static_cast<size_t>(end - start);
+        if (scratch) {
+            size_t mark = scratch->mark();
+            if (char* dst = scratch->alloc(cap)) {
+                Napi::String s = Napi::String::New(env, dst, url_decode_into(dst, start, end));
+                scratch->rewind(mark);
+                return s;
+            }
         }
-        return out;
+
+        thread_local std::string out;
+        out.resize(cap);
+        return Napi::String::New(env, out.data(), url_decode_into(out.data(), start, end));
     }
 
-    inline static bool parse_query_params(
+    inline static void set_query_pair(
         Napi::Env env,
-        const char* __restrict url,
-        uint32_t* __restrict offset,
+        ScratchArena* scratch,
         Napi::Object* query_params,
-        uint32_t query_limit
-    ) noexcept
-    {
-        const char* p = url + *offset;
+        const char* key_start,
+        const char* val_start,
+        const char* end
+    ) {
+        const char* key_end = val_start ? (val_start - 1) : end;
 
-        if (*p == '?') p++;
+        Napi::String key = url_decode(env, scratch, key_start, key_end);
+        Napi::String value = val_start ? url_decode(env, scratch, val_start, end) : Napi::String::New(env, "");
 
-        uint32_t scanned = 0;
+        query_params->Set(key, value);
+    }
 
-        const char* key_start = p;
+    // Decode the '&'-separated pairs of [begin, end) into query_params.
+    inline static void decode_query_pairs(
+        Napi::Env env,
+        ScratchArena* scratch,
+        const char* __restrict begin,
+        const char* __restrict end,
+        Napi::Object* query_params
+    ) noexcept
+    {
+        const char* key_start = begin;
         const char* val_start = nullptr;
+        const char* p = begin;
 
-        while (*p != '\0') {
-
-            // ---- LAST POINT CONTROLLERS ----
-            if (*p == ' ' || *p == '\r' || *p == '\n' || *p == '#') {
-                break;
-            }
-
-            scanned++;
-
-            if (scanned > query_limit) {
-                return false; // QUERY LIMIT EXCEEDED
-            }
-
+        while ((p = simd_find_any<'&', '='>(p, end)) != end) {
             if (*p == '=') {
                 val_start = p + 1;
-            }
-            else if (*p == '&') {
-
-                const char* key_end = val_start ? (val_start - 1) : p;
-                const char* val_end = val_start ? p : p;
-
-                auto key = url_decode(key_start, key_end);
-                auto value = val_start ? url_decode(val_start, val_end) : "";
-
-                query_params->Set(key, value);
+            } else {
+                set_query_pair(env, scratch, query_params, key_start, val_start, p);
 
                 key_start = p + 1;
                 val_start = nullptr;
             }
+            ++p;
+        }
 
-            p++;
+        if (key_start < p) {
+            set_query_pair(env, scratch, query_params, key_start, val_start, p);
         }
+    }
+
+    // Find the end of the query at url + *offset (leading '?' skipped) and
+    // check it against query_limit. On success *offset is advanced by the
+    // query length and [*begin, *end) holds the query bytes. Only the first
+    // query_limit + 1 bytes are looked at.
+    inline static bool scan_query(
+        const char* __restrict url,
+        size_t urlLen,
+        uint32_t* __restrict offset,
+        uint32_t query_limit,
+        const char** begin,
+        const char** end
+    ) noexcept
+    {
+        const char* p = url + *offset;
+        const char* url_end = url + urlLen;
 
-        if (key_start && key_start < p) {
-            const char* key_end = val_start ? (val_start - 1) : p;
-            const char* val_end = val_start ? p : p;
+        if (p < url_end && *p == '?') p++;
 
-            auto key = url_decode(key_start, key_end);
-            auto value = val_start ? url_decode(val_start, val_end) : "";
+        const char* window = (static_cast<size_t>(url_end - p) > query_limit) ? p + query_limit + 1 : url_end;
 
-            query_params->Set(key, value);
+        // ---- LAST POINT CONTROLLERS ----
+        const char* q = simd_find_any<' ', '\r', '\n', '#', '\0'>(p, window);
+        if (q == window && window != url_end) {
+            return false; // QUERY LIMIT EXCEEDED
         }
 
-        *offset += scanned;
+        *begin = p;
+        *end = q;
+        *offset += static_cast<uint32_t>(q - p);
+
+        return true;
+    }
+
+    // Eager mode decodes the pairs into query->params, deferred mode only
+    // records the span for a later parseQuery call.
+    inline static bool parse_query_params(
+        Napi::Env env,
+        const char* __restrict url,
+        size_t urlLen,
+        uint32_t* __restrict offset,
+        QueryOut* query,
+        uint32_t query_limit
+    ) noexcept
+    {
+        const char* begin;
+        const char* end;
+
+        if (!scan_query(url, urlLen, offset, query_limit, &begin, &end)) return false;
+
+        if (query->params) {
+            decode_query_pairs(env, query->scratch, begin, end, query->params);
+        } else {
+            query->start = static_cast<uint32_t>(begin - url);
+            query->len = static_cast<uint32_t>(end - begin);
+        }
 
         return true;
     }
@@ -159,26 +284,85 @@ namespace {
 } // namespace
 
 
+//===----------------------------------------------------------------------===//
+// parseQuery Implementation
+//===----------------------------------------------------------------------===//
+void RouteBuilder::parseQuery(
+    Napi::Env env,
+    const char* query,
+    size_t len,
+    Napi::Object* queryParams,
+    ScratchArena* scratch
+    ) noexcept
+{
+    decode_query_pairs(env, scratch, query, query + len, queryParams);
+}
+
+
+//===----------------------------------------------------------------------===//
+// matchStaticUrl Implementation
+//===----------------------------------------------------------------------===//
+int RouteBuilder::matchStaticUrl(
+    Napi::Env env,
+    const StaticRouteTable& table,
+    const char* url,
+    size_t urlLen,
+    uint32_t* offset,
+    QueryOut* query_params,
+    uint32_t query_limit
+    ) noexcept
+{
+    if (!table || *offset >= urlLen) return -1;
+
+    const char* path = url + *offset;
+    size_t limit = urlLen - *offset;
+    if (limit > table.max_len + 1) limit = table.max_len + 1;
+
+    // Hash while looking for the end of the path.
+    uint32_t h = 2166136261u ^ table.seed;
+    size_t len = 0;
+    for (; len < limit; ++len) {
+        char c = path[len];
+        if (c == ' ' || c == '?') break;
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    if (len == limit) return -1;
+
+    uint32_t d = table.displace[h & table.bucket_mask];
+    const StaticRouteSlot& slot = table.slots[staticRouteSlot(h, d) & table.mask];
+    if (slot.len != len || std::memcmp(table.paths.data() + slot.path_offset, path, len) != 0) return -1;
+
+    *offset += static_cast<uint32_t>(len);
+    if (url[*offset] == '?') {
+        if (!parse_query_params(env, url, urlLen, offset, query_params, query_limit)) return -2;
+        *offset += 1;
+    }
+    return slot.vptr_table_index;
+}
+
+
 //===----------------------------------------------------------------------===//
 // matchUrl Implementation
 //===----------------------------------------------------------------------===//
 int RouteBuilder::matchUrl(
     Napi::Env env,
-    const std::shared_ptr<RouteNode>& root,
+    const RouteTable& table,
     const char* url,
     size_t urlLen,
     uint32_t* offset,
     Napi::Array* path_params,
-    Napi::Object* query_params,
+    QueryOut* query_params,
     uint32_t query_limit
     ) noexcept
 {
-    auto node = root;
+    if (!table) return -1;
 
-    if (!node) return -1;
+    const FlatRouteNode* nodes = table.nodes.data();
+    const FlatRouteNode* node = nodes;
 
-    if (!node->is_param && node->value_length > 0) {
-        if (!nodeStaticMatches(node, url, offset)) {
+    if (node->kind != kParam && node->value_length > 0) {
+        if (!nodeStaticMatches(table, *node, url, urlLen, offset)) {
             return -1;
         }
         *offset += node->value_length;
@@ -186,18 +370,40 @@ int RouteBuilder::matchUrl(
 
     uint32_t path_index = 0;
     bool matched = false;
+
+    // Segments taken by a numeric param that still has a later param or
+    // wildcard sibling, retried with that sibling if the numeric subtree
+    // dead-ends.
+    struct ParamChoice {
+        const FlatRouteNode* parent;
+        const FlatRouteNode* next;
+        uint32_t offset;
+        uint32_t path_index;
+    };
+    ParamChoice choices[kMaxParamChoices];
+    uint32_t choice_count = 0;
+    const FlatRouteNode* resume = nullptr;
     
     while (true) {
         matched = false;
 
+        const FlatRouteNode* child = nodes + node->first_child;
+        const FlatRouteNode* end = child + node->child_count;
+        const FlatRouteNode* statics_end = child + node->static_count;
+        bool wide = node->static_count >= kWideFanout;
+
+        if (resume) {
+            child = resume;
+            resume = nullptr;
+        } else if (wide) {
+            int idx = selectStaticChild(table, *node, static_cast<uint8_t>(url[*offset]));
+            child = idx >= 0 ? child + idx : statics_end;
+        }
+
         #pragma clang loop vectorize(disable)
         #pragma clang loop unroll(disable)
-        for (auto& child : node->children) {
-            if (!child) continue;
-            // Line caches Opt
-            // __builtin_prefetch(child.get(), 0, 1);
-
-            if (child->is_param) [[unlikely]] {
+        for (; child != end; ++child) {
+            if (child->kind == kParam) [[unlikely]] {
                 const char* p = url + *offset;
                 size_t start = *offset;
 
@@ -205,9 +411,21 @@ int RouteBuilder::matchUrl(
                 // __builtin_assume(p >= url && p <= url + urlLen);
 
                 size_t param_len = p - (url + start);
-                std::string param_value(url + start, param_len);
 
-                path_params->Set(path_index++, Napi::String::New(env, param_value));
+                if (child->param_type == ParamType::kNumber) {
+                    // A non-numeric segment goes straight to the next
+                    // sibling (string param / wildcard). A numeric one is
+                    // taken here, with a choice point so that sibling still
+                    // gets it if nothing below this param matches.
+                    uint64_t number;
+                    if (!parseNumberParam(url + start, param_len, &number)) continue;
+                    if (child + 1 != end && choice_count < kMaxParamChoices) {
+                        choices[choice_count++] = { node, child + 1, static_cast<uint32_t>(start), path_index };
+                    }
+                    path_params->Set(path_index++, Napi::Number::New(env, static_cast<double>(number)));
+                } else {
+                    path_params->Set(path_index++, Napi::String::New(env, url + start, param_len));
+                }
                 
                 *offset += param_len;
                 
@@ -216,7 +434,7 @@ int RouteBuilder::matchUrl(
 
                 if ((child->vptr_table_index != -1) && (url[*offset] == ' ' || url[*offset] == '?')) [[likely]] {
                     if (url[*offset] == '?') {
-                        if (!parse_query_params(env, url, offset, query_params, query_limit)) return -2;
+                        if (!parse_query_params(env, url, urlLen, offset, query_params, query_limit)) return -2;
                         *offset += 1;
                     }
                     return child->vptr_table_index;
@@ -225,13 +443,13 @@ int RouteBuilder::matchUrl(
                 break;
             }
             else [[likely]] {
-                if (child->is_wildcard) [[unlikely]] {
+                if (child->kind == kWildcard) [[unlikely]] {
                     #pragma clang loop vectorize(disable)
                     #pragma clang loop unroll(disable)
                     while (url[*offset] != ' ') {
                         if (*offset > 1000) return -3;
                         if (url[*offset] == '?') {
-                           if(!parse_query_params(env, url, offset, query_params, query_limit)) return -2;
+                           if(!parse_query_params(env, url, urlLen, offset, query_params, query_limit)) return -2;
                            *offset += 1;
                            break;
                         }
@@ -240,7 +458,7 @@ int RouteBuilder::matchUrl(
                     return child->vptr_table_index;
                 }
 
-                if (nodeStaticMatches(child, url, offset)) {
+                if (nodeStaticMatches(table, *child, url, urlLen, offset)) {
                     *offset += child->value_length;
 
                     node = child;
@@ -249,17 +467,34 @@ int RouteBuilder::matchUrl(
                     if (child->vptr_table_index != -1 && (url[*offset] == ' ' || url[*offset] == '?')) {
                         // Parse Query
                         if (url[*offset] == '?') {
-                           if(!parse_query_params(env, url, offset, query_params, query_limit)) return -2;
+                           if(!parse_query_params(env, url, urlLen, offset, query_params, query_limit)) return -2;
                            *offset += 1;
                         }
                         return child->vptr_table_index;
                     }
                     break;
                 }
+
+                // The selected candidate was the only static child that could
+                // match, continue with the param / wildcard children.
+                if (wide) child = statics_end - 1;
             }
         }
 
-        if (!matched) break;
+        if (!matched) {
+            if (choice_count == 0) break;
+
+            // Dead end below a numeric param: rewind to its segment and
+            // continue with the sibling after it.
+            const ParamChoice& choice = choices[--choice_count];
+            node = choice.parent;
+            resume = choice.next;
+            *offset = choice.offset;
+            if (path_index != choice.path_index) {
+                path_index = choice.path_index;
+                path_params->Set("length", Napi::Number::New(env, path_index));
+            }
+        }
     }
 
     return -1;
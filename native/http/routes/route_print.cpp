@@ -8,7 +8,7 @@ void RouteBuilder::printRouteTree(const std::shared_ptr<RouteNode>& node, int de
     if (node->is_param) {
         std::cout << "PARAM(" << node->param_name << ")";
     } else if (node->value_length > 0) {
-        std::cout << "STATIC(len=" << node->value_length << ", hex=" << std::hex << node->value << std::dec << ")";
+        std::cout << "STATIC(len=" << node->value_length << ", \"" << node->segment << "\")";
     } else {
         std::cout << "ROOT";
     }
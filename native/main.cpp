@@ -4,6 +4,9 @@
 #include <asset_parser.h>
 #include <cpool.h>
 #include <asset_parser.h>
+#include "alloc_stats.h"
+#include "response_serializer.h"
+#include "chunked_decoder.h"
 
 inline const char* scan_url(
     const char* __restrict curl,
@@ -40,12 +43,46 @@ Napi::Value ScanUrl(const Napi::CallbackInfo& info) {
     return Napi::String::New(env, url);
 }
 
+Napi::Value ParseQuery(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsNumber()) [[unlikely]] {
+        Napi::TypeError::New(env, "Expected (buffer: Buffer, start: number, len: number, scratch?: Buffer)").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto buf = info[0].As<Napi::Buffer<char>>();
+    uint32_t start = info[1].As<Napi::Number>().Uint32Value();
+    uint32_t len = info[2].As<Napi::Number>().Uint32Value();
+
+    if ((size_t)start + len > buf.Length()) [[unlikely]] {
+        Napi::RangeError::New(env, "Query span out of buffer bounds").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    ScratchArena scratch = ScratchArena::fromArg(info, 3);
+    Napi::Object query = Napi::Object::New(env);
+    RouteBuilder::parseQuery(env, buf.Data() + start, len, &query, &scratch);
+    return query;
+}
+
+#ifdef HYPERNODE_ALLOC_STATS
+Napi::Value AllocCount(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), (double)allocCount());
+}
+#endif
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("HttpCore", HttpCore::GetClass(env));
     exports.Set("PublicAssetParser", PublicAssetParser::GetClass(env));
+    exports.Set("ChunkedDecoder", ChunkedDecoder::GetClass(env));
     
     exports.Set("scanUrl", Napi::Function::New(env, ScanUrl));
+    exports.Set("parseQuery", Napi::Function::New(env, ParseQuery));
+    exports.Set("serializeResponse", Napi::Function::New(env, SerializeResponse));
+#ifdef HYPERNODE_ALLOC_STATS
+    exports.Set("allocCount", Napi::Function::New(env, AllocCount));
+#endif
 
     exports.Set("CPool", CPool::GetClass(env));
     return exports;
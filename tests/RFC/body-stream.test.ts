@@ -0,0 +1,56 @@
+import { describe, it, expect } from "vitest";
+import StreamingChunkedParser from "../../ts/http/chunker/StreamingChunkedParser";
+import { BodyStream } from "../../ts/http/chunker/BodyStream";
+
+describe("Streamed request bodies", () => {
+  it("passes chunked data through as it arrives, split anywhere (RFC 9112 §7.1)", () => {
+    const slices: string[] = [];
+    const parser = new StreamingChunkedParser();
+    parser.setSink((s) => slices.push(s.toString()));
+
+    const wire = "5\r\nhello\r\nC\r\n, streaming!\r\n0\r\n\r\n";
+    let from = 0;
+    for (const cut of [2, 6, 9, 14, 20, wire.length]) {
+      parser.write(Buffer.from(wire.slice(from, cut)));
+      from = cut;
+    }
+
+    expect(parser.isFinished()).toBe(true);
+    expect(slices.join("")).toBe("hello, streaming!");
+    // "hello" arrived across two writes and was not held back.
+    expect(slices[0]).toBe("hel");
+  });
+
+  it("still collects the body when no sink is set", () => {
+    const parser = new StreamingChunkedParser();
+    parser.write(Buffer.from("3\r\nabc\r\n2\r"));
+    parser.write(Buffer.from("\nde\r\n0\r\n\r\n"));
+    expect(parser.isFinished()).toBe(true);
+    expect(parser.getBody().toString()).toBe("abcde");
+  });
+
+  it("asks the framer to pause until the handler takes a queued slice", async () => {
+    let drained = 0;
+    const body = new BodyStream(() => drained++);
+
+    expect(body.push(Buffer.from("a"))).toBe(false);
+    const first = await body.next();
+    expect(first.value.toString()).toBe("a");
+    expect(drained).toBe(1);
+
+    const pending = body.next();
+    expect(body.push(Buffer.from("b"))).toBe(true);
+    expect((await pending).value.toString()).toBe("b");
+
+    body.end();
+    expect((await body.next()).done).toBe(true);
+    expect(body.received).toBe(2);
+  });
+
+  it("rejects a pending read when the connection goes away", async () => {
+    const body = new BodyStream(() => {});
+    const pending = body.next();
+    body.abort(new Error("closed"));
+    await expect(pending).rejects.toThrow("closed");
+  });
+});
@@ -0,0 +1,79 @@
+import { describe, it, expect } from "vitest";
+import hypernode from "../setup";
+
+const { ChunkedDecoder } = hypernode;
+
+const MORE = 0, DONE = 1, DEST_FULL = 2;
+const ERR_SIZE = -1, ERR_TOO_LARGE = -2, ERR_EXTENSION = -3, ERR_TRAILER = -4, ERR_CRLF = -5;
+
+function decode(wire: string, opts: { max?: number; dest?: number; step?: number } = {}) {
+  const dec = new ChunkedDecoder();
+  dec.reset(opts.max ?? 1 << 20);
+  let dest = Buffer.alloc(opts.dest ?? 1024);
+  const input = Buffer.from(wire, "latin1");
+  const step = opts.step ?? input.length;
+
+  let at = 0;
+  let status = MORE;
+  while (at < input.length) {
+    const end = Math.min(at + step, input.length);
+    status = dec.write(input.subarray(at, end), dest);
+    at += dec.consumed();
+    if (status === DEST_FULL) {
+      const next = Buffer.alloc(dest.length * 2);
+      dest.copy(next);
+      dest = next;
+      continue;
+    }
+    if (status !== MORE) break;
+  }
+
+  return { status, body: dest.toString("latin1", 0, dec.length()), rest: wire.slice(at) };
+}
+
+describe("Native chunked decoder (RFC 9112 §7.1)", () => {
+  const wire = "5\r\nhello\r\nC;name=\"v\"\r\n, streaming!\r\n0\r\nX-Trailer: 1\r\n\r\n";
+
+  it("compacts the chunk data into one buffer and stops after the trailer section", () => {
+    const r = decode(wire + "GET / HTTP/1.1\r\n");
+    expect(r.status).toBe(DONE);
+    expect(r.body).toBe("hello, streaming!");
+    expect(r.rest).toBe("GET / HTTP/1.1\r\n");
+  });
+
+  it("resumes across arbitrary splits and a growing destination", () => {
+    const r = decode(wire, { step: 1, dest: 2 });
+    expect(r.status).toBe(DONE);
+    expect(r.body).toBe("hello, streaming!");
+  });
+
+  it("rejects malformed chunk sizes", () => {
+    expect(decode("ZZ\r\n").status).toBe(ERR_SIZE);
+    expect(decode(";a\r\n").status).toBe(ERR_SIZE);
+    expect(decode("1".repeat(17) + "\r\n").status).toBe(ERR_SIZE);
+  });
+
+  it("rejects bare LF and missing CRLF after chunk data", () => {
+    expect(decode("5\nhello\r\n0\r\n\r\n").status).toBe(ERR_CRLF);
+    expect(decode("2\r\nabc\r\n0\r\n\r\n").status).toBe(ERR_CRLF);
+  });
+
+  it("enforces maxContentSize before copying a chunk", () => {
+    const r = decode("4\r\nabcd\r\n5\r\nefghi\r\n0\r\n\r\n", { max: 8 });
+    expect(r.status).toBe(ERR_TOO_LARGE);
+    expect(r.body).toBe("abcd");
+  });
+
+  it("limits chunk extensions to visible bytes after a ';'", () => {
+    expect(decode("1 ;a=b\r\nx\r\n0\r\n\r\n").status).toBe(DONE);
+    expect(decode("1 x\r\nx\r\n0\r\n\r\n").status).toBe(ERR_EXTENSION);
+    expect(decode("1;a\x01\r\nx\r\n0\r\n\r\n").status).toBe(ERR_EXTENSION);
+    expect(decode("1;" + "a".repeat(5000) + "\r\nx\r\n0\r\n\r\n").status).toBe(ERR_EXTENSION);
+  });
+
+  it("rejects obs-fold and nameless trailer fields", () => {
+    expect(decode("0\r\nA: 1\r\n folded\r\n\r\n").status).toBe(ERR_TRAILER);
+    expect(decode("0\r\n: x\r\n\r\n").status).toBe(ERR_TRAILER);
+    expect(decode("0\r\nA B: x\r\n\r\n").status).toBe(ERR_TRAILER);
+  });
+});
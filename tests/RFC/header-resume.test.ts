@@ -0,0 +1,58 @@
+import { describe, it, expect } from "vitest";
+import { runChunked } from "../helpers/run";
+import { expectFlag } from "../helpers/assertFlag";
+import { Http } from "../../ts/http";
+
+const RET_FLAG = 1, MAIN_OFFSET = 2, RESUME_STATE = 6;
+const RESUME_VALUE = 1;
+
+const RAW =
+  "GET /search HTTP/1.1\r\n" +
+  "Host:   example.com  \r\n" +
+  "Content-Length: 0\r\n" +
+  "Accept: text/html\r\n" +
+  "Cookie: session=" + "a".repeat(200) + "\r\n" +
+  "Accept: */*\r\n" +
+  "\r\n";
+
+function spanList(buf: Buffer, spans: Uint32Array) {
+  const out: string[] = [];
+  for (let i = 0; i < spans[0]; i++) {
+    const o = 1 + i * 5;
+    out.push(
+      buf.toString("latin1", spans[o + 1], spans[o + 1] + spans[o + 2]) + "=" +
+      buf.toString("latin1", spans[o + 3], spans[o + 3] + spans[o + 4])
+    );
+  }
+  return out;
+}
+
+describe("Resumable header scanning", () => {
+  it("byte-by-byte delivery yields the same headers as one chunk", () => {
+    const whole = runChunked(RAW, RAW.length);
+    expectFlag(whole.slots[RET_FLAG], Http.RetFlagBits.FLAG_OK);
+
+    for (const step of [1, 2, 3, 7, 16]) {
+      const split = runChunked(RAW, step);
+      expectFlag(split.slots[RET_FLAG], Http.RetFlagBits.FLAG_OK);
+      expect(split.slots[MAIN_OFFSET]).toBe(whole.slots[MAIN_OFFSET]);
+      expect(spanList(split.buf, split.spans)).toEqual(spanList(whole.buf, whole.spans));
+    }
+  });
+
+  it("continues inside a cut-off value instead of rescanning the line", () => {
+    const { states, slots } = runChunked(RAW, 5);
+
+    expect(states).toContain(RESUME_VALUE);
+    expect(slots[RESUME_STATE]).toBe(0);
+  });
+
+  it("accepts a CRLF split across chunks", () => {
+    const raw = "GET /search HTTP/1.1\r\nHost: a\r\n\r\n";
+    for (let step = 6; step <= 10; step++) {
+      const { slots } = runChunked(raw, step);
+      expectFlag(slots[RET_FLAG], Http.RetFlagBits.FLAG_OK);
+      expect(slots[MAIN_OFFSET]).toBe(raw.length);
+    }
+  });
+});
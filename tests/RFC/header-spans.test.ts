@@ -0,0 +1,38 @@
+import { describe, it, expect } from "vitest";
+import { runSpans } from "../helpers/run";
+import { expectFlag } from "../helpers/assertFlag";
+import { Http } from "../../ts/http";
+
+function spanValue(buf: Buffer, spans: Uint32Array, i: number) {
+  const o = 1 + i * 5;
+  return buf.toString("latin1", spans[o + 3], spans[o + 3] + spans[o + 4]);
+}
+
+describe("Header span scan mode", () => {
+  it("records header offsets without touching the headers object", () => {
+    const { req, spans, buf } = runSpans(
+      "GET /search HTTP/1.1\r\nHost: test\r\nX-Trace:  abc  \r\n\r\n"
+    );
+
+    expectFlag(req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(Object.keys(req.headers).length).toBe(0);
+    expect(spans[0]).toBe(2);
+    expect(spanValue(buf, spans, 0)).toBe("test");
+    expect(spanValue(buf, spans, 1)).toBe("abc");
+    expect(buf.toString("latin1", spans[1 + 5 + 1], spans[1 + 5 + 1] + spans[1 + 5 + 2])).toBe("X-Trace");
+  });
+
+  it("duplicate Host header should fail", () => {
+    const { req } = runSpans(
+      "GET /search HTTP/1.1\r\nHost: a\r\nHost: b\r\n\r\n"
+    );
+    expectFlag(req.retFlag, Http.RetFlagBits.FLAG_DUPLICATE_SINGLE_HEADER);
+  });
+
+  it("span table overflow should fail", () => {
+    let headers = "";
+    for (let i = 0; i < 17; i++) headers += `X-${i}: a\r\n`;
+    const { req } = runSpans("GET /search HTTP/1.1\r\n" + headers + "\r\n");
+    expectFlag(req.retFlag, Http.RetFlagBits.FLAG_MAX_HEADER_SIZE);
+  });
+});
@@ -53,4 +53,48 @@ describe("Header syntax", () => {
     );
     expectFlag(req.retFlag, Http.RetFlagBits.FLAG_DUPLICATE_SINGLE_HEADER);
   });
+
+  it("repeated mergeable headers are joined in order", () => {
+    const { req } = run(
+      "GET /search HTTP/1.1\r\n" +
+      "Host: a\r\n" +
+      "Accept: text/html\r\n" +
+      "Cache-Control: no-cache\r\n" +
+      "Accept: application/json\r\n" +
+      "Cache-Control: max-age=0\r\n" +
+      "Accept: */*\r\n\r\n"
+    );
+
+    expectFlag(req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(req.headers["accept"]).toBe("text/html, application/json, */*");
+    expect(req.headers["cache-control"]).toBe("no-cache, max-age=0");
+  });
+
+  it("proxy-split Via and X-Forwarded-For are joined", () => {
+    const { req } = run(
+      "GET /search HTTP/1.1\r\n" +
+      "Host: a\r\n" +
+      "Via: 1.1 edge\r\n" +
+      "X-Forwarded-For: 203.0.113.7\r\n" +
+      "Via: 1.1 lb\r\n" +
+      "X-Forwarded-For: 10.0.0.1\r\n\r\n"
+    );
+
+    expectFlag(req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(req.headers["via"]).toBe("1.1 edge, 1.1 lb");
+    expect(req.headers["x-forwarded-for"]).toBe("203.0.113.7, 10.0.0.1");
+  });
+
+  it("more repeats than the merge table holds are still joined", () => {
+    let lines = "";
+    const expected: string[] = [];
+    for (let i = 0; i < 40; i++) {
+      lines += `Accept-Encoding: e${i}\r\n`;
+      expected.push(`e${i}`);
+    }
+    const { req } = run("GET /search HTTP/1.1\r\nHost: a\r\n" + lines + "\r\n");
+
+    expectFlag(req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(req.headers["accept-encoding"]).toBe(expected.join(", "));
+  });
 });
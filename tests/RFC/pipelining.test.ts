@@ -0,0 +1,116 @@
+import { describe, it, expect } from "vitest";
+import net from "net";
+import { run } from "../helpers/run";
+import { expectFlag } from "../helpers/assertFlag";
+import { listen, exchange } from "../helpers/server";
+import { Http } from "../../ts/http";
+import * as Factory from "../../ts/http/factory/factory";
+
+describe("HTTP/1.1 pipelining (RFC 9112 §9.3.2)", () => {
+  it("stops at the end of the first request and leaves the next one at mainOffset", () => {
+    const first = "GET /search HTTP/1.1\r\nHost: test\r\n\r\n";
+    const second = "POST /query HTTP/1.1\r\nHost: test\r\nContent-Length: 0\r\n\r\n";
+
+    const a = run(first + second);
+    expectFlag(a.req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(a.ret).toBe(3);
+    expect(a.req.mainOffset).toBe(first.length);
+
+    const b = run((first + second).slice(a.req.mainOffset));
+    expectFlag(b.req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(b.ret).toBe(2);
+    expect(b.req.headers["content-length"]).toBe("0");
+  });
+
+  it("finds the next request after a fixed-length body", () => {
+    const first = "POST /query HTTP/1.1\r\nHost: test\r\nContent-Length: 5\r\n\r\nhello";
+    const second = "GET /search HTTP/1.1\r\nHost: test\r\n\r\n";
+
+    const a = run(first + second);
+    expectFlag(a.req.retFlag, Http.RetFlagBits.FLAG_OK);
+
+    const next = a.req.mainOffset + Number(a.req.headers["content-length"]);
+    expect(next).toBe(first.length);
+
+    const b = run((first + second).slice(next));
+    expectFlag(b.req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(b.ret).toBe(3);
+  });
+
+  it("reports a cut-off second request as unterminated", () => {
+    const first = "GET /search HTTP/1.1\r\nHost: test\r\n\r\n";
+    const a = run(first + "GET /search HTTP/1.1\r\nHo");
+
+    const b = run((first + "GET /search HTTP/1.1\r\nHo").slice(a.req.mainOffset));
+    expectFlag(b.req.retFlag, Http.RetFlagBits.FLAG_UNTERMINATED_HEADERS);
+  });
+});
+
+describe("HTTP/1.1 pipelining over a socket", () => {
+  const root = Factory.createRoute("/api")
+    .addEndpoint(Factory.createEndpoint(Http.HttpMethod.GET, "/a", (req, res) => res.send("a")))
+    .addEndpoint(Factory.createEndpoint(Http.HttpMethod.GET, "/b", (req, res) => res.send("b")))
+    .addEndpoint(Factory.createEndpoint(Http.HttpMethod.GET, "/slow", async (req, res) => {
+      await new Promise((r) => setTimeout(r, 20));
+      res.send("slow");
+    }))
+    .addEndpoint(Factory.createEndpoint(Http.HttpMethod.POST, "/echo", (req, res) => {
+      res.send(String(req.body));
+    }))
+    .addEndpoint(Factory.createEndpoint(Http.HttpMethod.GET, "/big", (req, res) => res.send("x".repeat(64 * 1024))));
+
+  const get = (path: string) => `GET ${path} HTTP/1.1\r\nHost: test\r\n\r\n`;
+
+  it("answers two GETs that arrive in one chunk, in order", async () => {
+    const srv = await listen(root);
+    const { responses } = await exchange(srv.port, [get("/api/a") + get("/api/b")], 2);
+    await srv.close();
+
+    expect(responses.map(r => r.body)).toEqual(["a", "b"]);
+  });
+
+  it("finds a GET behind a POST body in the same chunk", async () => {
+    const srv = await listen(root);
+    const post = "POST /api/echo HTTP/1.1\r\nHost: test\r\nContent-Length: 5\r\n\r\nhello";
+    const { responses } = await exchange(srv.port, [post + get("/api/b")], 2);
+    await srv.close();
+
+    expect(responses.map(r => r.body)).toEqual(["hello", "b"]);
+  });
+
+  it("feeds the leftover bytes once an async handler is done", async () => {
+    const srv = await listen(root);
+    const { responses } = await exchange(srv.port, [get("/api/slow") + get("/api/a") + get("/api/b")], 3);
+    await srv.close();
+
+    expect(responses.map(r => r.body)).toEqual(["slow", "a", "b"]);
+  });
+
+  it("waits for a client that does not read instead of running out of responses", async () => {
+    const srv = await listen(root, { maxRequests: 4 });
+    const n = 200;
+
+    const received: Buffer[] = [];
+    const socket = net.connect(srv.port, "127.0.0.1");
+    socket.on("data", (d) => received.push(d));
+    await new Promise((r) => socket.on("connect", r));
+
+    // Far more responses than the pool holds, none of them read for a while.
+    socket.pause();
+    socket.write(get("/api/big").repeat(n));
+    await new Promise((r) => setTimeout(r, 200));
+    socket.resume();
+
+    const statuses = () => Buffer.concat(received).toString("latin1").match(/HTTP\/1\.1 \d{3}/g) ?? [];
+    const deadline = Date.now() + 5000;
+    while (statuses().length < n && !socket.destroyed && Date.now() < deadline) {
+      await new Promise((r) => setTimeout(r, 50));
+    }
+    const seen = statuses();
+    socket.destroy();
+    await srv.close();
+
+    expect(seen.length).toBe(n);
+    expect(seen.every(s => s === "HTTP/1.1 200")).toBe(true);
+  });
+});
@@ -0,0 +1,189 @@
+import { describe, it, expect } from "vitest";
+import hypernode from "../setup";
+import { PipeResponseBase } from "../../ts/http/response/PipeResponseBase";
+import { RouteBuilder } from "../../ts/http/factory/route";
+import { dateHeader, DATE_HEADER_LEN } from "../../ts/http/response/HttpDate";
+
+const { serializeResponse } = hypernode;
+
+const DATE_LINE = /^HTTP\/1\.1 [^\r]*\r\nDate: [A-Z][a-z]{2}, \d{2} [A-Z][a-z]{2} \d{4} \d{2}:\d{2}:\d{2} GMT\r\n/;
+
+/** Drops the Date line that follows the status line of a pooled response. */
+function undated(buf: Buffer) {
+  const text = buf.toString();
+  expect(text).toMatch(DATE_LINE);
+  const eol = text.indexOf("\r\n") + 2;
+  return text.slice(0, eol) + text.slice(eol + DATE_HEADER_LEN);
+}
+
+function serialize(status: number, headers: Record<string, string>, body: Buffer | string | number, size = 4096) {
+  const out = Buffer.alloc(size);
+  const n = serializeResponse(status, Object.keys(headers), Object.values(headers), body, out);
+  return { n, text: n < 0 ? "" : out.toString("latin1", 0, n) };
+}
+
+describe("Native response serializer (RFC 9112 §4)", () => {
+  it("writes status line with reason phrase, headers, Content-Length and body", () => {
+    const { text } = serialize(200, { "Content-Type": "application/json" }, '{"ok":true}');
+    expect(text).toBe(
+      "HTTP/1.1 200 OK\r\n" +
+      "Content-Type: application/json\r\n" +
+      "Content-Length: 11\r\n\r\n" +
+      '{"ok":true}'
+    );
+  });
+
+  it("keeps a status code without a known reason phrase well-formed", () => {
+    expect(serialize(299, {}, "").text).toBe("HTTP/1.1 299 \r\nContent-Length: 0\r\n\r\n");
+  });
+
+  it("rejects status codes outside 100..599", () => {
+    expect(() => serialize(99, {}, "")).toThrow(RangeError);
+    expect(() => serialize(600, {}, "")).toThrow(RangeError);
+  });
+
+  it("counts the UTF-8 length of a string body", () => {
+    const { text } = serialize(201, {}, "ğüş");
+    expect(text.startsWith("HTTP/1.1 201 Created\r\nContent-Length: 6\r\n\r\n")).toBe(true);
+  });
+
+  it("copies a Buffer body and only sets the length for a number body", () => {
+    expect(serialize(200, {}, Buffer.from("abc")).text).toBe("HTTP/1.1 200 OK\r\nContent-Length: 3\r\n\r\nabc");
+    expect(serialize(200, {}, 70000).text).toBe("HTTP/1.1 200 OK\r\nContent-Length: 70000\r\n\r\n");
+  });
+
+  it("derives Content-Length from the body and drops a user supplied one", () => {
+    const { text } = serialize(200, { "content-length": "999", "X-A": "1" }, "hi");
+    expect(text).toBe("HTTP/1.1 200 OK\r\nX-A: 1\r\nContent-Length: 2\r\n\r\nhi");
+  });
+
+  it("refuses CR/LF in header names and values (response splitting)", () => {
+    expect(() => serialize(200, { "X-A": "1\r\nSet-Cookie: x=1" }, "")).toThrow(TypeError);
+    expect(() => serialize(200, { "X-A\n": "1" }, "")).toThrow(TypeError);
+  });
+
+  it("returns -1 when the output buffer is too small", () => {
+    expect(serialize(200, { "X-Long": "a".repeat(100) }, "", 64).n).toBe(-1);
+    expect(serialize(200, {}, "a".repeat(100), 64).n).toBe(-1);
+  });
+
+  it("only uses the first headerCount header entries", () => {
+    const out = Buffer.alloc(256);
+    const n = serializeResponse(204, ["X-A", "X-Stale"], ["1", "2"], "", out, 1);
+    expect(out.toString("latin1", 0, n)).toBe("HTTP/1.1 204 No Content\r\nX-A: 1\r\nContent-Length: 0\r\n\r\n");
+  });
+});
+
+describe("Pooled response output", () => {
+  function pooled() {
+    const freed: number[] = [];
+    const res = new PipeResponseBase();
+    res.setCPool({ free: (id: number) => freed.push(id) }, 7);
+    return { res, freed };
+  }
+
+  it("reuses its output slab and clears headers on release", () => {
+    const { res, freed } = pooled();
+
+    res.setHeader("X-A", "1");
+    res.json({ a: 1 });
+    const first = res.getResp() as Buffer;
+    expect(undated(first)).toBe(
+      "HTTP/1.1 200 OK\r\nX-A: 1\r\nContent-Type: application/json\r\nContent-Length: 7\r\n\r\n{\"a\":1}"
+    );
+
+    res.freeCPool();
+    expect(freed).toEqual([7]);
+    expect(res.getHeaders()).toEqual({});
+
+    res.send("ok");
+    const second = res.getResp() as Buffer;
+    expect(undated(second)).toBe("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+    expect(second.buffer).toBe(first.buffer);
+    expect(second.byteOffset).toBe(first.byteOffset);
+  });
+
+  it("adds the shared, pre-encoded Date header", () => {
+    const { res } = pooled();
+    res.send("");
+    expect((res.getResp() as Buffer).toString()).toMatch(DATE_LINE);
+    expect(dateHeader().length).toBe(DATE_HEADER_LEN);
+    expect(dateHeader().toString()).toBe(`Date: ${new Date(Date.parse(dateHeader().toString().slice(6))).toUTCString()}\r\n`);
+  });
+
+  it("replaces a header set twice instead of repeating it", () => {
+    const { res } = pooled();
+    res.setHeader("X-A", "1").setHeader("X-A", "2").send("");
+    expect(undated(res.getResp() as Buffer)).toBe("HTTP/1.1 200 OK\r\nX-A: 2\r\nContent-Length: 0\r\n\r\n");
+  });
+
+  it("copies the route's static header block right after the status line", () => {
+    const block = RouteBuilder.encodeStaticHeaders(
+      { "Content-Type": "application/json", "Cache-Control": "no-store" },
+      "Access-Control-Allow-Origin: *"
+    );
+    const { res } = pooled();
+    res.setStaticHeaders(block).setHeader("X-Id", "9").send("{}");
+
+    expect(undated(res.getResp() as Buffer)).toBe(
+      "HTTP/1.1 200 OK\r\n" +
+      "Content-Type: application/json\r\nCache-Control: no-store\r\nAccess-Control-Allow-Origin: *\r\n" +
+      "X-Id: 9\r\nContent-Length: 2\r\n\r\n{}"
+    );
+
+    res.freeCPool();
+    res.send("");
+    expect(undated(res.getResp() as Buffer)).toBe("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+  });
+
+  it("does not repeat a static header set again by the handler", () => {
+    const block = RouteBuilder.encodeStaticHeaders(
+      { "Content-Type": "application/json; charset=utf-8", "Cache-Control": "no-store" },
+      ""
+    );
+    const names = RouteBuilder.staticHeaderNames(block);
+    expect(names).toEqual(["content-type", "cache-control"]);
+
+    // json() keeps the route's Content-Type.
+    const { res } = pooled();
+    res.setStaticHeaders(block, names).json({});
+    expect(undated(res.getResp() as Buffer)).toBe(
+      "HTTP/1.1 200 OK\r\n" +
+      "Content-Type: application/json; charset=utf-8\r\nCache-Control: no-store\r\n" +
+      "Content-Length: 2\r\n\r\n{}"
+    );
+
+    // An explicit setHeader replaces the static value.
+    res.freeCPool();
+    res.setStaticHeaders(block, names).setHeader("cache-control", "max-age=60").send("");
+    expect(undated(res.getResp() as Buffer)).toBe(
+      "HTTP/1.1 200 OK\r\n" +
+      "Content-Type: application/json; charset=utf-8\r\n" +
+      "cache-control: max-age=60\r\nContent-Length: 0\r\n\r\n"
+    );
+
+    // The override does not outlive the request.
+    res.freeCPool();
+    res.setStaticHeaders(block, names).send("");
+    expect(undated(res.getResp() as Buffer)).toBe(
+      "HTTP/1.1 200 OK\r\n" +
+      "Content-Type: application/json; charset=utf-8\r\nCache-Control: no-store\r\n" +
+      "Content-Length: 0\r\n\r\n"
+    );
+  });
+
+  it("rejects static headers that could split the response", () => {
+    expect(RouteBuilder.encodeStaticHeaders(undefined, "")).toBe(null);
+    expect(() => RouteBuilder.encodeStaticHeaders({ "X-A": "1\r\nX-B: 2" }, "")).toThrow();
+    expect(() => RouteBuilder.encodeStaticHeaders({ "Content-Length": "1" }, "")).toThrow();
+  });
+
+  it("writes large bodies as a separate buffer", () => {
+    const { res } = pooled();
+    res.send("x".repeat(4096));
+    const ret = res.getResp() as Buffer[];
+    expect(Array.isArray(ret)).toBe(true);
+    expect(undated(ret[0])).toBe("HTTP/1.1 200 OK\r\nContent-Length: 4096\r\n\r\n");
+    expect(ret[1].length).toBe(4096);
+  });
+});
@@ -0,0 +1,43 @@
+import { describe, it, expect } from "vitest";
+import { run, runSlots } from "../helpers/run";
+import { expectFlag } from "../helpers/assertFlag";
+import { Http } from "../../ts/http";
+import hypernode from "../setup";
+
+const METHOD = 0, RET_FLAG = 1, MAIN_OFFSET = 2, HEADER_SIZE = 3, QUERY_START = 4, QUERY_LEN = 5;
+
+describe("Result slot bank", () => {
+  it("writes scalar results into the slots instead of the request object", () => {
+    const raw = "GET /search HTTP/1.1\r\nHost: test\r\n\r\n";
+    const { ret, req, slots } = runSlots(raw);
+    const legacy = run(raw);
+
+    expect(ret).toBe(legacy.ret);
+    expectFlag(slots[RET_FLAG], Http.RetFlagBits.FLAG_OK);
+    expect(slots[METHOD]).toBe(legacy.req.method);
+    expect(slots[MAIN_OFFSET]).toBe(legacy.req.mainOffset);
+    expect(slots[HEADER_SIZE]).toBe(legacy.req.headerSize);
+
+    expect(req.mainOffset).toBe(0);
+    expect(req.headerSize).toBe(0);
+  });
+
+  it("reports errors through the retFlag slot", () => {
+    const { slots } = runSlots("GET /missing HTTP/1.1\r\nHost: test\r\n\r\n");
+    expectFlag(slots[RET_FLAG], Http.RetFlagBits.FLAG_NOT_FOUND);
+  });
+
+  it("defers the query string to parseQuery", () => {
+    const { req, slots, buf } = runSlots("GET /search?a=1&b=%41 HTTP/1.1\r\nHost: test\r\n\r\n");
+
+    expectFlag(slots[RET_FLAG], Http.RetFlagBits.FLAG_OK);
+    expect(req.query).toEqual({});
+    expect(buf.toString("latin1", slots[QUERY_START], slots[QUERY_START] + slots[QUERY_LEN])).toBe("a=1&b=%41");
+    expect(hypernode.parseQuery(buf, slots[QUERY_START], slots[QUERY_LEN])).toEqual({ a: "1", b: "A" });
+  });
+
+  it("still enforces the query limit in deferred mode", () => {
+    const { slots } = runSlots("GET /search?a=1&b=2&c=3&d=4 HTTP/1.1\r\nHost: test\r\n\r\n");
+    expectFlag(slots[RET_FLAG], Http.RetFlagBits.FLAG_REQUEST_QUERY_EXCEEDED);
+  });
+});
@@ -1,7 +1,9 @@
 import { describe, it, expect } from "vitest";
 import { run } from "../helpers/run";
 import { expectFlag } from "../helpers/assertFlag";
+import { listen, exchange } from "../helpers/server";
 import { Http } from "../../ts/http";
+import * as Factory from "../../ts/http/factory/factory";
 
 describe("Request smuggling protection", () => {
   it("CL + Transfer-Encoding must be rejected", () => {
@@ -29,4 +31,58 @@ describe("Request smuggling protection", () => {
     expectFlag(req.retFlag, Http.RetFlagBits.BAD_REQUEST);
   });
   */
+
+  describe("GET/HEAD with a body (CL.0 desync)", () => {
+    let calls = 0;
+    const root = Factory.createRoute("/api").addEndpoint(
+      Factory.createEndpoint(Http.HttpMethod.GET, "/search", (req, res) => {
+        calls++;
+        res.send("ok");
+      })
+    );
+
+    const smuggled =
+      "GET /api/search HTTP/1.1\r\nHost: test\r\n\r\n";
+
+    it("answers 400 and closes instead of parsing the body as a request", async () => {
+      const srv = await listen(root);
+      calls = 0;
+      const { responses, closed } = await exchange(srv.port, [
+        "GET /api/search HTTP/1.1\r\n" +
+        "Host: test\r\n" +
+        `Content-Length: ${smuggled.length}\r\n\r\n` +
+        smuggled
+      ], 2);
+      await srv.close();
+
+      expect(responses.map(r => r.status)).toEqual([400]);
+      expect(closed).toBe(true);
+      expect(calls).toBe(0);
+    });
+
+    it("refuses Transfer-Encoding on GET", async () => {
+      const srv = await listen(root);
+      const { responses, closed } = await exchange(srv.port, [
+        "GET /api/search HTTP/1.1\r\n" +
+        "Host: test\r\n" +
+        "Transfer-Encoding: chunked\r\n\r\n" +
+        "0\r\n\r\n"
+      ], 2);
+      await srv.close();
+
+      expect(responses.map(r => r.status)).toEqual([400]);
+      expect(closed).toBe(true);
+    });
+
+    it("still accepts Content-Length: 0", async () => {
+      const srv = await listen(root);
+      const { responses } = await exchange(srv.port, [
+        "GET /api/search HTTP/1.1\r\nHost: test\r\nContent-Length: 0\r\n\r\n"
+      ], 1);
+      await srv.close();
+
+      expect(responses.map(r => r.status)).toEqual([200]);
+      expect(responses[0].body).toBe("ok");
+    });
+  });
 });
@@ -0,0 +1,72 @@
+import { describe, it, expect } from "vitest";
+import hypernode from "../setup";
+import { freshReqObj } from "../helpers/freshReq";
+import { expectFlag } from "../helpers/assertFlag";
+import { Http } from "../../ts/http";
+
+const { HttpCore } = hypernode;
+
+const httpCore = new HttpCore();
+
+httpCore.registerRoutes([
+  { method: "GET", route: "/users/:/", vptrTableIndex: 0, paramTypes: [Http.RouteParamType.NUMBER] },
+  { method: "GET", route: "/orders/:/items/:/", vptrTableIndex: 1, paramTypes: [Http.RouteParamType.NUMBER, Http.RouteParamType.STRING] },
+  { method: "GET", route: "/tags/:/", vptrTableIndex: 2, paramTypes: [Http.RouteParamType.NUMBER] },
+  { method: "GET", route: "/tags/:/", vptrTableIndex: 3 },
+]);
+
+function run(raw: string) {
+  const req = freshReqObj();
+  const ret = httpCore.scannerRouteFirst(Buffer.from(raw), req, 4 * 1024, 4 * 1024, 8 * 1024, 10);
+  return { ret, req };
+}
+
+describe("Typed route params", () => {
+  it("numeric params are delivered as numbers", () => {
+    const { ret, req } = run("GET /users/42 HTTP/1.1\r\nHost: a\r\n\r\n");
+    expect(ret).toBe(0);
+    expect(req.params).toEqual([42]);
+  });
+
+  it("mixed param types keep their order", () => {
+    const { ret, req } = run("GET /orders/7/items/abc HTTP/1.1\r\nHost: a\r\n\r\n");
+    expect(ret).toBe(1);
+    expect(req.params).toEqual([7, "abc"]);
+  });
+
+  it("non-numeric segment is rejected during matching", () => {
+    const { req } = run("GET /users/abc HTTP/1.1\r\nHost: a\r\n\r\n");
+    expectFlag(req.retFlag, Http.RetFlagBits.FLAG_NOT_FOUND);
+  });
+
+  it("non-numeric segment falls through to a string param sibling", () => {
+    expect(run("GET /tags/12 HTTP/1.1\r\nHost: a\r\n\r\n").ret).toBe(2);
+    expect(run("GET /tags/news HTTP/1.1\r\nHost: a\r\n\r\n").ret).toBe(3);
+  });
+
+  it("a numeric segment that dead-ends is retried with the string param sibling", () => {
+    const core = new HttpCore();
+    core.registerRoutes([
+      { method: "GET", route: "/tags/:/x", vptrTableIndex: 0, paramTypes: [Http.RouteParamType.NUMBER] },
+      { method: "GET", route: "/tags/:/y", vptrTableIndex: 1 },
+    ]);
+    const match = (path: string) => {
+      const req = freshReqObj();
+      const ret = core.scannerRouteFirst(Buffer.from(`GET ${path} HTTP/1.1\r\nHost: a\r\n\r\n`), req, 4 * 1024, 4 * 1024, 8 * 1024, 10);
+      return { ret, params: req.params };
+    };
+
+    expect(match("/tags/12/x")).toEqual({ ret: 0, params: [12] });
+    expect(match("/tags/12/y")).toEqual({ ret: 1, params: ["12"] });
+    expect(match("/tags/news/y")).toEqual({ ret: 1, params: ["news"] });
+    expect(match("/tags/12/z").ret).toBe(-1);
+  });
+
+  it("getParamTypes reads :name(int) declarations", async () => {
+    const { RouteBuilder } = await import("../../ts/http/factory/route");
+    expect(RouteBuilder.getParamTypes("/orders/:id(int)/items/:name")).toEqual([
+      Http.RouteParamType.NUMBER,
+      Http.RouteParamType.STRING,
+    ]);
+  });
+});
@@ -1,5 +1,6 @@
 import hypernode from "../setup";
 import { freshReqObj } from "./freshReq";
+import { Http } from "../../ts/http";
 
 const { HttpCore } = hypernode;
 
@@ -31,3 +32,97 @@ export function run(raw: string) {
 
   return { ret, req };
 }
+
+export function runSpans(raw: string) {
+  const buf = Buffer.from(raw);
+  const req = freshReqObj();
+  const spans = new Uint32Array(1 + 5 * 16);
+
+  const ret = httpCore.scannerRouteFirst(
+    buf,
+    req,
+    MAX_HEADER_NAME_SIZE,
+    MAX_HEADER_VALUE_SIZE,
+    MAX_HEADER_SIZE,
+    QUERY_LIMIT,
+    spans
+  );
+
+  return { ret, req, spans, buf };
+}
+
+export function runSlots(raw: string) {
+  const buf = Buffer.from(raw);
+  const req = freshReqObj();
+  const spans = new Uint32Array(1 + 5 * 16);
+  const slots = new Int32Array(6);
+
+  const ret = httpCore.scannerRouteFirst(
+    buf,
+    req,
+    MAX_HEADER_NAME_SIZE,
+    MAX_HEADER_VALUE_SIZE,
+    MAX_HEADER_SIZE,
+    QUERY_LIMIT,
+    spans,
+    slots
+  );
+
+  return { ret, req, spans, slots, buf };
+}
+
+export function runChunked(raw: string, step: number) {
+  const full = Buffer.from(raw);
+  const req = freshReqObj();
+  const spans = new Uint32Array(1 + 5 * 16);
+  const slots = new Int32Array(12);
+
+  // The request line always arrives whole, headers then come `step` bytes at a time.
+  let len = Math.min(full.indexOf("\r\n") + 2 + step, full.length);
+  const ret = httpCore.scannerRouteFirst(
+    full.subarray(0, len),
+    req,
+    MAX_HEADER_NAME_SIZE,
+    MAX_HEADER_VALUE_SIZE,
+    MAX_HEADER_SIZE,
+    QUERY_LIMIT,
+    spans,
+    slots
+  );
+
+  const states: number[] = [];
+  while (slots[1] === Http.RetFlagBits.FLAG_UNTERMINATED_HEADERS && len < full.length) {
+    states.push(slots[6]);
+    len = Math.min(len + step, full.length);
+    httpCore.scannerHeader(
+      full.subarray(0, len),
+      req,
+      MAX_HEADER_NAME_SIZE,
+      MAX_HEADER_VALUE_SIZE,
+      MAX_HEADER_SIZE,
+      spans,
+      slots
+    );
+  }
+
+  return { ret, req, spans, slots, buf: full, states };
+}
+
+export function runScratch(raw: string, scratch?: Buffer) {
+  const buf = Buffer.from(raw);
+  const req = freshReqObj();
+
+  const ret = httpCore.scannerRouteFirst(
+    buf,
+    req,
+    MAX_HEADER_NAME_SIZE,
+    MAX_HEADER_VALUE_SIZE,
+    MAX_HEADER_SIZE,
+    QUERY_LIMIT,
+    undefined,
+    undefined,
+    scratch
+  );
+
+  return { ret, req };
+}
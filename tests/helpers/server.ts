@@ -0,0 +1,88 @@
+import net from "net";
+import { createServer } from "../../ts/index";
+import { Http } from "../../ts/http";
+
+export type RawResponse = {
+  status: number;
+  head: string;
+  body: string;
+};
+
+/**
+ * Starts an API server for `root` on a free loopback port.
+ */
+export async function listen(root: Http.Route, opts?: Http.ServerOptions) {
+  const ctx = createServer({ maxRequests: 16, ...opts }).Api(root);
+  await new Promise<void>((resolve) => ctx.listen(0, "127.0.0.1", undefined, resolve));
+  const port = (ctx.server.address() as net.AddressInfo).port;
+
+  return {
+    ctx,
+    port,
+    close: () => new Promise<void>((resolve) => ctx.server.close(() => resolve())),
+  };
+}
+
+/**
+ * Splits the complete, Content-Length framed responses off the front of `data`.
+ */
+function parseResponses(data: Buffer): RawResponse[] {
+  const out: RawResponse[] = [];
+  let off = 0;
+
+  while (off < data.length) {
+    const end = data.indexOf("\r\n\r\n", off);
+    if (end === -1) break;
+
+    const head = data.toString("latin1", off, end);
+    const len = Number(/\r\ncontent-length:\s*(\d+)/i.exec(head)?.[1] ?? 0);
+    if (end + 4 + len > data.length) break;
+
+    out.push({
+      status: Number(head.slice(9, 12)),
+      head,
+      body: data.toString("utf-8", end + 4, end + 4 + len),
+    });
+    off = end + 4 + len;
+  }
+
+  return out;
+}
+
+/**
+ * Writes `chunks` to a new connection, one socket write each, and collects
+ * responses until `count` arrived, the server closed or `timeoutMs` passed.
+ */
+export function exchange(
+  port: number,
+  chunks: (string | Buffer)[],
+  count: number,
+  timeoutMs = 2000
+): Promise<{ responses: RawResponse[]; closed: boolean }> {
+  return new Promise((resolve) => {
+    const socket = net.connect(port, "127.0.0.1");
+    const received: Buffer[] = [];
+    let closed = false;
+
+    const done = () => {
+      clearTimeout(timer);
+      socket.destroy();
+      resolve({ responses: parseResponses(Buffer.concat(received)), closed });
+    };
+    const timer = setTimeout(done, timeoutMs);
+
+    socket.on("connect", () => {
+      for (const c of chunks) socket.write(c);
+    });
+    socket.on("data", (d) => {
+      received.push(d);
+      if (parseResponses(Buffer.concat(received)).length >= count) done();
+    });
+    socket.on("end", () => {
+      closed = true;
+      done();
+    });
+    socket.on("error", () => {});
+    socket.on("close", done);
+  });
+}
@@ -0,0 +1,53 @@
+import { describe, it, expect } from "vitest";
+import { run, runScratch } from "../helpers/run";
+import { expectFlag } from "../helpers/assertFlag";
+import { Http } from "../../ts/http";
+import hypernode from "../setup";
+
+const RAW =
+  "GET /search?q=a+b%2Bc&x=%41 HTTP/1.1\r\n" +
+  "Host: a\r\n" +
+  "X-Some-Long-Custom-Header: 1\r\n" +
+  "Accept: text/html\r\n" +
+  "Accept: */*\r\n\r\n";
+
+// Only present in builds configured with `node-gyp rebuild -- -Dalloc_stats=1`.
+const allocCount: (() => number) | undefined = hypernode.allocCount;
+
+describe("Native scratch arena", () => {
+  it("gives the same result with and without a scratch buffer", () => {
+    const heap = run(RAW);
+    const arena = runScratch(RAW, Buffer.alloc(4096));
+
+    expectFlag(arena.req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(arena.req.headers).toEqual(heap.req.headers);
+    expect(arena.req.query).toEqual({ q: "a b+c", x: "A" });
+  });
+
+  it("falls back to the heap when the scratch buffer is too small", () => {
+    const { req } = runScratch(RAW, Buffer.alloc(4));
+
+    expectFlag(req.retFlag, Http.RetFlagBits.FLAG_OK);
+    expect(req.headers["x-some-long-custom-header"]).toBe("1");
+    expect(req.headers["accept"]).toBe("text/html, */*");
+  });
+
+  it.skipIf(!allocCount)("steady-state scans make no heap allocations", () => {
+    const scratch = Buffer.alloc(16 * 1024);
+    for (let i = 0; i < 100; i++) runScratch(RAW, scratch);
+
+    const before = allocCount!();
+    for (let i = 0; i < 1000; i++) runScratch(RAW, scratch);
+
+    expect(allocCount!() - before).toBe(0);
+  });
+
+  it.skipIf(!allocCount)("the counter sees the heap fallback", () => {
+    for (let i = 0; i < 100; i++) runScratch(RAW);
+
+    const before = allocCount!();
+    for (let i = 0; i < 100; i++) runScratch(RAW);
+
+    expect(allocCount!() - before).toBeGreaterThan(0);
+  });
+});
@@ -0,0 +1,80 @@
+import { describe, it, expect } from "vitest";
+import FixedChunkedParser from "../../ts/http/chunker/FixedChunkedParser";
+import ChunkProgression from "../../ts/http/chunker/ChunkProgression";
+import { acquireSlab, releaseSlab, SLAB_CLASSES } from "../../ts/http/chunker/BodySlab";
+
+describe("Pooled body slabs", () => {
+  it("reuses the connection's slab for the next keep-alive body", () => {
+    const acc = new FixedChunkedParser();
+
+    acc.allocateBuffer(300);
+    acc.write(Buffer.from("a".repeat(300)));
+    const first = acc.getBody();
+    acc.free();
+
+    acc.allocateBuffer(200);
+    acc.write(Buffer.from("b".repeat(200)));
+    const second = acc.getBody();
+
+    expect(second.buffer).toBe(first.buffer);
+    expect(second.byteOffset).toBe(first.byteOffset);
+    expect(second.toString()).toBe("b".repeat(200));
+  });
+
+  it("picks the smallest size class and recycles released slabs", () => {
+    const small = acquireSlab(10);
+    expect(small.length).toBe(SLAB_CLASSES[0]);
+    releaseSlab(small);
+    expect(acquireSlab(SLAB_CLASSES[0])).toBe(small);
+
+    expect(acquireSlab(SLAB_CLASSES[0] + 1).length).toBe(SLAB_CLASSES[1]);
+  });
+
+  it("hands a large slab back once the request is done", () => {
+    const acc = new FixedChunkedParser();
+    acc.allocateBuffer(SLAB_CLASSES[1] + 1);
+    const slab = acc.getBody().buffer;
+    acc.free();
+
+    const reused = acquireSlab(SLAB_CLASSES[2]);
+    expect(reused.buffer).toBe(slab);
+  });
+
+  it("does not recycle the slab of a request still in flight when the connection closes", () => {
+    const p = new ChunkProgression({ free: () => {} }, () => {}, {}, 1024);
+    p.chunkParser.fixed.allocateBuffer(SLAB_CLASSES[1] + 1);
+    p.chunkParser.fixed.write(Buffer.alloc(SLAB_CLASSES[1] + 1, "a"));
+    const body = p.chunkParser.fixed.getBody();
+
+    // An async handler still holds req.body.
+    p.routePipe = {};
+    p.free();
+
+    const next = acquireSlab(SLAB_CLASSES[2]);
+    expect(next.buffer).not.toBe(body.buffer);
+    next.fill("b");
+    expect(body[0]).toBe(0x61);
+  });
+
+  it("hands the body slab to the response instead of the next pipelined body", () => {
+    const p = new ChunkProgression({ free: () => {} }, () => {}, {}, 1024);
+    p.chunkParser.fixed.allocateBuffer(300);
+    p.chunkParser.fixed.write(Buffer.alloc(300, "a"));
+    const body = p.chunkParser.fixed.getBody();
+
+    // respond(): the response may still be queued with a view of the body.
+    const slab = p.detachBodySlab();
+    expect(slab).not.toBe(null);
+    expect(body.buffer).toBe(slab!.buffer);
+    p.reset();
+
+    p.chunkParser.fixed.allocateBuffer(300);
+    p.chunkParser.fixed.write(Buffer.alloc(300, "b"));
+    expect(p.chunkParser.fixed.getBody().buffer).not.toBe(body.buffer);
+    expect(body.toString()).toBe("a".repeat(300));
+
+    // Released from the write callback, it serves the next body again.
+    releaseSlab(slab!);
+    expect(acquireSlab(300)).toBe(slab);
+  });
+});
@@ -0,0 +1,116 @@
+import { describe, it, expect } from "vitest";
+import hypernode from "../setup";
+import { SharedCPool } from "../../ts/http/context/SharedCPool";
+
+function pool(size: number) {
+  const p = new SharedCPool(new hypernode.CPool());
+  p.initializePool(size);
+  const objs = Array.from({ length: size }, (_, i) => ({ i }));
+  const ids = objs.map((o) => p.registerObj(o));
+  return { p, objs, ids };
+}
+
+describe("CPool free stack and registration", () => {
+  it("hands out every object once and refuses when exhausted", () => {
+    const { p } = pool(4);
+    const got = new Set([p.allocate(), p.allocate(), p.allocate(), p.allocate()]);
+    expect(got.size).toBe(4);
+    expect(p.allocate()).toBe(null);
+  });
+
+  it("ignores a double free", () => {
+    const { p, objs, ids } = pool(2);
+    const a = p.allocate();
+    const id = ids[objs.indexOf(a)];
+    p.free(id);
+    p.free(id);
+
+    expect(p.allocate()).toBe(a);
+    expect(p.allocate()).not.toBe(null);
+    expect(p.allocate()).toBe(null);
+  });
+
+  it("keeps JS and native views in sync across a shrink with slots in use", () => {
+    const { p, objs, ids } = pool(4);
+    const held = [p.allocate(), p.allocate(), p.allocate(), p.allocate()];
+    const retired = held.filter((o) => ids[objs.indexOf(o)] >= 2);
+
+    p.resizePool(2);
+    for (const o of held) p.free(ids[objs.indexOf(o)]);
+
+    // Only the two active slots come back.
+    const again = [p.allocate(), p.allocate(), p.allocate()];
+    expect(again[2]).toBe(null);
+    expect(retired.every((o) => !again.includes(o))).toBe(true);
+  });
+
+  it("keeps retired objects in flight across a shrink and a later grow", () => {
+    const { p, objs, ids } = pool(10);
+    const held = Array.from({ length: 10 }, () => p.allocate());
+    const idOf = (o: any) => ids[objs.indexOf(o)];
+
+    p.resizePool(5);
+    // Two retired slots finish before the grow, three stay in flight across it.
+    for (const o of held.filter((o) => idOf(o) >= 8)) p.free(idOf(o));
+    p.resizePool(8);
+
+    expect(p.vacant()).toBe(0);
+    for (const o of held.filter((o) => idOf(o) < 8)) p.free(idOf(o));
+    const again = Array.from({ length: 9 }, () => p.allocate());
+    expect(again.slice(0, 8).every((o) => o !== null)).toBe(true);
+    expect(again[8]).toBe(null);
+  });
+
+  it("leaves a slot emptied by a retired free on the stack until it is registered", () => {
+    const { p, objs, ids } = pool(4);
+    const held = [p.allocate(), p.allocate(), p.allocate(), p.allocate()];
+    const idOf = (o: any) => ids[objs.indexOf(o)];
+
+    p.resizePool(2);
+    p.free(idOf(held.find((o) => idOf(o) === 2)));
+    p.resizePool(3);
+    for (const o of held) p.free(idOf(o));
+
+    expect(p.vacant()).toBe(1);
+    expect(p.allocate()).not.toBe(null);
+    expect(p.allocate()).not.toBe(null);
+    // Slot 2 lost its object to the retired free; it is neither handed out
+    // empty nor popped off the stack.
+    expect(p.allocate()).toBe(null);
+    expect(p.allocate()).toBe(null);
+
+    const obj = { late: true };
+    expect(p.registerObj(obj)).toBe(2);
+    expect(p.allocate()).toBe(obj);
+    expect(p.allocate()).toBe(null);
+  });
+
+  it("registers a whole array in one call, in slot order", () => {
+    const native = new hypernode.CPool();
+    native.initializePool(3);
+    const objs = [{ a: 1 }, { a: 2 }, { a: 3 }];
+
+    expect(Array.from(native.registerMany(objs))).toEqual([0, 1, 2]);
+    expect(() => native.registerObj({})).toThrow("No free registration slot");
+    expect(() => native.registerMany([1])).toThrow(TypeError);
+  });
+
+  it("registers nothing when the batch does not fit", () => {
+    const native = new hypernode.CPool();
+    native.initializePool(3);
+    native.registerObj({});
+
+    expect(() => native.registerMany([{}, {}, {}])).toThrow("No free registration slot");
+    expect(Array.from(native.registerMany([{}, {}]))).toEqual([1, 2]);
+  });
+
+  it("reuses slots emptied by a shrink when the pool grows again", () => {
+    const native = new hypernode.CPool();
+    native.initializePool(4);
+    native.registerMany([{}, {}, {}, {}]);
+
+    native.resizePool(2);
+    native.resizePool(3);
+    expect(native.registerObj({})).toBe(2);
+  });
+});
@@ -0,0 +1,41 @@
+import { describe, it, expect } from "vitest";
+import hypernode from "../setup";
+import { freshReqObj } from "../helpers/freshReq";
+
+const { HttpCore } = hypernode;
+
+function routeOf(core: any, path: string) {
+  const req = freshReqObj();
+  return core.scannerRouteFirst(Buffer.from(`GET ${path} HTTP/1.1\r\nHost: a\r\n\r\n`), req, 4 * 1024, 4 * 1024, 8 * 1024, 10);
+}
+
+describe("Static route hash", () => {
+  it("registers many static routes in linear space and time", () => {
+    const n = 20_000;
+    const routes = [];
+    for (let i = 0; i < n; i++) {
+      routes.push({ method: "GET", route: `/r${(i * 2654435761 >>> 0).toString(36)}/${i}`, vptrTableIndex: i });
+    }
+
+    const core = new HttpCore();
+    const start = Date.now();
+    expect(core.registerRoutes(routes)).toBe(n);
+    expect(Date.now() - start).toBeLessThan(2000);
+
+    for (const i of [0, 1, 4242, n - 1]) {
+      expect(routeOf(core, routes[i].route)).toBe(i);
+    }
+    expect(routeOf(core, "/nope")).toBe(-1);
+  });
+
+  it("serves the same routes through the trie when the hash is off", () => {
+    const routes = [
+      { method: "GET", route: "/a", vptrTableIndex: 0 },
+      { method: "GET", route: "/a/b", vptrTableIndex: 1 },
+    ];
+    const core = new HttpCore();
+    core.registerRoutes(routes, { staticRouteHash: false });
+    expect(routeOf(core, "/a/b")).toBe(1);
+    expect(routeOf(core, "/a")).toBe(0);
+  });
+});
@@ -1,6 +1,7 @@
 import net from "net";
 import { PipeResponseBase } from "./http/response/PipeResponseBase";
 import { ChunkParser } from "./http/chunker/ChunkParser";
+import { BodyStream } from "./http/chunker/BodyStream";
 
 export namespace Http {
     /**
@@ -72,11 +73,12 @@ export namespace Http {
         headers: Record<string, string>;
 
         /**
-         * @property {string[]} params
+         * @property {Array<string | number>} params
          * @description An array containing the values of the dynamic URL parameters defined in the route path.
          * E.g., for route "/users/:id", this array would contain the value of "id".
+         * Params declared as `:id(int)` are delivered as numbers.
          */
-        params: string[];
+        params: Array<string | number>;
 
         /**
          * @property {Record<string, string>} query
@@ -89,10 +91,22 @@ export namespace Http {
          * @property {T} body
          * @description The request payload (body). The type <T> is determined by the expected content
          * type and how the middleware/framework chooses to process it (e.g., JSON object, raw string, or Buffer).
+         * A raw Buffer body lives in the connection's pooled body slab and is reused once the response
+         * has been sent; copy it to keep it longer.
          */
         body: T;
     }
 
+    /**
+     * @enum RouteParamType
+     * @description Type of a route parameter, mirrors RouteBuilder::ParamType in native/http/routes/route.h.
+     * Declared in a route path as `:name` (STRING) or `:name(int)` (NUMBER).
+     */
+    export enum RouteParamType {
+        STRING = 1,
+        NUMBER = 2
+    }
+
     export enum HttpMethod {
         HEAD,
         GET,
@@ -248,6 +262,8 @@ export namespace Http {
         RESP_413: Buffer;
         /** Request-URI Too Large: The URI provided was too long for the server to process. */
         RESP_414: Buffer;
+        /** Service Unavailable: Every pooled response object is in use, e.g. by a client that does not read its responses. */
+        RESP_503: Buffer;
         /** No Content: The server successfully processed the request, and is not returning any content. */
         RESP_204: Buffer;
     };
@@ -478,6 +494,18 @@ export namespace Http {
          * Overrides global server limit.
          */
         maxHeaderSize?: number;
+
+        /**
+         * Response headers sent unchanged on every response of this endpoint.
+         * Pre-encoded once when the routes are built.
+         */
+        staticHeaders?: Record<string, string>;
+
+        /**
+         * Deliver the request body to the handler as it arrives (see `EndpointOpt.stream`).
+         * @default false
+         */
+        stream?: boolean;
     }
 
     /**
@@ -501,6 +529,35 @@ export namespace Http {
          * Overrides global maximum header size.
          */
         maxHeaderSize?: number;
+
+        /**
+         * Response headers that never change for this endpoint
+         * (e.g. `Content-Type`, `Cache-Control`).
+         *
+         * They are encoded once at route build time, together with the CORS
+         * headers, and copied into every response as one block; only dynamic
+         * headers and `Content-Length` are formatted per request. A handler
+         * that sets one of these names replaces the static value; the
+         * Content-Type added by `json()` leaves a static one in place.
+         */
+        headers?: Record<string, string>;
+
+        /**
+         * Streams the request body instead of buffering it.
+         *
+         * The pipeline runs as soon as the headers are parsed and `req.body`
+         * is a `BodyStream`, an async iterator of body slices
+         * (`for await (const slice of req.body)`). Fixed-length, chunked and
+         * until-end bodies are only framed, never copied or decoded; the socket
+         * is paused while a slice waits for the handler, so a connection holds
+         * about one socket chunk at a time. Content type and encoding parsers
+         * are not applied.
+         *
+         * A response sent before the whole body was read closes the
+         * connection, as does the response to a chunked body.
+         * @default false
+         */
+        stream?: boolean;
     }
 
     /**
@@ -559,6 +616,8 @@ export namespace Http {
         method: string;
         route: string;
         vptrTableIndex: number;
+        /** Types of the route params, in path order. Missing entries default to STRING. */
+        paramTypes?: RouteParamType[];
     }
 
     export interface Accumulate {
@@ -694,6 +753,23 @@ export namespace Http {
          * Maximum allowed header size in bytes for this route.
          */
         maxHeaderSize: number;
+
+        /**
+         * Pre-encoded `Name: value\r\n` lines of the endpoint's static
+         * headers and the CORS headers, or null when there are none.
+         */
+        staticHeaders: Buffer | null;
+
+        /**
+         * Lowercase names of the headers in `staticHeaders`, or null when
+         * there are none.
+         */
+        staticHeaderNames: string[] | null;
+
+        /**
+         * True when the endpoint receives its body as a `BodyStream`.
+         */
+        stream: boolean;
     }
 
 
@@ -764,6 +840,28 @@ export namespace Http {
          */
         allocateResp(): PipeResponseBase;
 
+        /**
+         * @method appendHeaderChunk
+         * @description Appends a chunk of a header block that spans several reads to `headerBuf` and points
+         * `rawBuf` at the bytes received so far. Falls back to a one-off concat only when the chunk does not fit.
+         * @param {Buffer} chunk - The newly received data buffer.
+         * @returns {Buffer} The buffer to scan, same as `rawBuf`.
+         */
+        appendHeaderChunk(chunk: Buffer): Buffer;
+
+        /**
+         * @method headerOverflow
+         * @description True when an unterminated header block has outgrown `headerBuf`.
+         */
+        headerOverflow(): boolean;
+
+        /**
+         * @method detachBodySlab
+         * @description Takes the body slab of the request being answered, to be released with `releaseSlab`
+         * once its response has been flushed. Null when the request had no buffered body.
+         */
+        detachBodySlab(): Buffer | null;
+
         /**
          * @property {number} objId
          * @description The unique identifier of this object within its associated object pool.
@@ -777,6 +875,23 @@ export namespace Http {
          */
         headers: Record<string, string>;
 
+        /**
+         * @property {Uint32Array} headerSpans
+         * @description Per-connection header offset table filled by the native scanner.
+         * Slot 0 holds the header count, followed by (HeaderId, nameStart, nameLen, valueStart, valueLen) tuples
+         * relative to `rawBuf`. `headers` is a lazy view over this table.
+         */
+        headerSpans: Uint32Array;
+
+        /**
+         * @property {Int32Array} resultSlots
+         * @description Per-connection slot bank the native scanner writes its scalar results into
+         * (method, retFlag, mainOffset, headerSize, queryStart, queryLen). `method`, `retFlag`, `mainOffset`
+         * and `headerSize` are accessors over these slots. The trailing slots hold the header scan resume
+         * state, so a header line cut off by a chunk boundary is continued rather than rescanned.
+         */
+        resultSlots: Int32Array;
+
         /**
          * @property {number} headerSize
          * @description The size, in bytes, of the currently accumulated raw header data.
@@ -792,14 +907,16 @@ export namespace Http {
         routePipe: RoutePipe;
 
         /**
-         * @property {string[]} params
+         * @property {Array<string | number>} params
          * @description An array of values extracted from the URL path as route parameters (e.g., `/users/:id` extracts `id`'s value).
+         * `:id(int)` params are parsed natively into numbers.
          */
-        params: string[];
+        params: Array<string | number>;
 
         /**
          * @property {Record<string, string>} query
          * @description A map containing the parsed URL query string parameters (e.g., `?a=1&b=2`).
+         * Decoded lazily from `rawBuf` on first access; the scanner only records the query span.
          */
         query: Record<string, string>;
 
@@ -819,7 +936,7 @@ export namespace Http {
         /**
          * @property {number} mainOffset
          * @description The byte offset within `rawBuf` where the **request body** begins (i.e., immediately after the double CRLF following the headers).
-         * This is essential for separating headers from body data.
+         * This is essential for separating headers from body data, and for finding the next pipelined request once the body is consumed.
          */
         mainOffset: number;
 
@@ -837,12 +954,46 @@ export namespace Http {
          */
         rawBuf: Buffer;
 
+        /**
+         * @property {Buffer} headerBuf
+         * @description Preallocated per-connection buffer (maxHeaderSize + requestQuerySize bytes) that collects
+         * a header block arriving over several chunks.
+         */
+        headerBuf: Buffer;
+
+        /**
+         * @property {Buffer} scratch
+         * @description Per-connection scratch arena for the native parser (lowercased header names, merged
+         * header values, percent-decoded query components). Same size as `headerBuf`; its contents only live
+         * for a single native call, so it never needs clearing.
+         */
+        scratch: Buffer;
+
         /**
          * @property {number} writeOffset
-         * @description The current write offset within `rawBuf` where the next incoming data chunk should be written.
+         * @description The current write offset within `headerBuf` where the next incoming data chunk should be written.
          */
         writeOffset: number;
 
+        /**
+         * @property {Buffer | null} pipelined
+         * @description Bytes of the next pipelined request left behind a finished request in the same chunk.
+         * Set by the accumulators while `feeding` and consumed by the `data` loop right after.
+         */
+        pipelined: Buffer | null;
+
+        /**
+         * @property {boolean} feeding
+         * @description True while a `data` chunk is being dispatched with the socket corked.
+         */
+        feeding: boolean;
+
+        /**
+         * @property {BodyStream | null} bodyStream
+         * @description Body of the current request on a `stream` endpoint, fed by the framers as chunks arrive.
+         */
+        bodyStream: BodyStream | null;
+
         /**
          * @property {ChunkParser} chunkParser
          * @description An internal object responsible for parsing chunked transfer encoding body data.
@@ -868,6 +1019,9 @@ export namespace Http {
         /** Sets multiple headers at once. */
         setHeaders(obj: Record<string, string>): this;
 
+        /** Sets the route's pre-encoded static header block (see `EndpointOpt.headers`) and its header names. */
+        setStaticHeaders(block: Buffer | null, names?: string[] | null): this;
+
         /** Sends plain text payload. */
         send(payload: string): void;
 
@@ -877,10 +1031,16 @@ export namespace Http {
         /** Sends redirect response. */
         redirect(url: string, code?: number): void;
 
-        /** Produces raw HTTP buffer for socket write. */
-        getResp(): Buffer;
+        /**
+         * Produces the raw HTTP response for socket write.
+         * An array is written as separate iovecs of a single writev (e.g. header block, body).
+         */
+        getResp(): Buffer | Buffer[];
 
-        /** Releases object back to pool. */
+        /**
+         * Releases object back to pool. Passed as the write callback of the
+         * response, since the buffers from `getResp` may point into pooled memory.
+         */
         freeCPool(): void;
     }
 
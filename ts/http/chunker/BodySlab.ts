@@ -0,0 +1,43 @@
+/**
+ * Size-classed buffers for request bodies, shared by all connections.
+ *
+ * A body is decoded into a slab of the smallest class that fits it. Slabs
+ * come from a per-class free list and go back to it instead of being left
+ * to the GC, so steady keep-alive traffic with bodies allocates nothing.
+ * Bodies larger than the biggest class get an exact, unpooled buffer.
+ */
+
+/** Slab sizes, smallest first. */
+export const SLAB_CLASSES = [4 * 1024, 64 * 1024, 1024 * 1024];
+
+/** How many idle slabs of each class are kept (about 1MB, 2MB and 4MB). */
+const MAX_FREE = [256, 32, 4];
+
+const freeLists: Buffer[][] = SLAB_CLASSES.map(() => []);
+
+function classOf(size: number): number {
+    for (let i = 0; i < SLAB_CLASSES.length; i++) {
+        if (size <= SLAB_CLASSES[i]) return i;
+    }
+    return -1;
+}
+
+/** A buffer of at least `size` bytes, contents undefined. */
+export function acquireSlab(size: number): Buffer {
+    const cls = classOf(size);
+    if (cls === -1) return Buffer.allocUnsafeSlow(size);
+    // Not from the shared allocation pool: a slab may be held for long and
+    // must not pin unrelated pool memory.
+    return freeLists[cls].pop() ?? Buffer.allocUnsafeSlow(SLAB_CLASSES[cls]);
+}
+
+/** Returns a slab from `acquireSlab`; oversized buffers are simply dropped. */
+export function releaseSlab(slab: Buffer): void {
+    const cls = classOf(slab.length);
+    if (cls === -1 || slab.length !== SLAB_CLASSES[cls]) return;
+    const list = freeLists[cls];
+    if (list.length < MAX_FREE[cls]) list.push(slab);
+}
+
+/** Slabs of at most this size stay with their connection between requests. */
+export const RETAINED_SLAB_SIZE = SLAB_CLASSES[1];
@@ -0,0 +1,88 @@
+/**
+ * Request body handed to `stream: true` endpoints as `req.body`.
+ *
+ * Body slices are pushed by the framers as socket chunks arrive and read by
+ * the handler with `for await (const slice of req.body)`. A slice is queued
+ * only until the handler asks for it: when `push()` finds nobody waiting it
+ * returns false and the caller pauses the socket, `onDrain` resumes it once
+ * the queue is empty again. Per-connection memory therefore stays at about
+ * one socket chunk regardless of the body size.
+ */
+export class BodyStream implements AsyncIterableIterator<Buffer> {
+    /** Bytes of body received so far. */
+    received: number = 0;
+
+    /** True once the framer has seen the end of the body. */
+    complete: boolean = false;
+
+    /** Bytes that followed the body in its last chunk (next pipelined request). */
+    rest: Buffer | null = null;
+
+    private queue: Buffer[] = [];
+    private waiting: ((r: IteratorResult<Buffer>) => void) | null = null;
+    private failWaiting: ((err: Error) => void) | null = null;
+    private failure: Error | null = null;
+    private onDrain: () => void;
+
+    constructor(onDrain: () => void) {
+        this.onDrain = onDrain;
+    }
+
+    /**
+     * Delivers a body slice. Returns false if it had to be queued, i.e. the
+     * caller should stop reading until `onDrain`.
+     */
+    push(slice: Buffer): boolean {
+        this.received += slice.length;
+        if (this.waiting !== null) {
+            const resolve = this.waiting;
+            this.waiting = this.failWaiting = null;
+            resolve({ value: slice, done: false });
+            return true;
+        }
+        this.queue.push(slice);
+        return false;
+    }
+
+    /** Marks the end of the body. */
+    end(rest: Buffer | null = null) {
+        this.complete = true;
+        this.rest = rest;
+        if (this.waiting !== null) {
+            const resolve = this.waiting;
+            this.waiting = this.failWaiting = null;
+            resolve({ value: undefined, done: true });
+        }
+    }
+
+    /** Fails pending and future reads, e.g. when the connection closes mid-body. */
+    abort(err: Error) {
+        if (this.complete) return;
+        this.failure = err;
+        this.queue.length = 0;
+        if (this.failWaiting !== null) {
+            const reject = this.failWaiting;
+            this.waiting = this.failWaiting = null;
+            reject(err);
+        }
+    }
+
+    next(): Promise<IteratorResult<Buffer>> {
+        if (this.queue.length !== 0) {
+            const value = this.queue.shift()!;
+            if (this.queue.length === 0) this.onDrain();
+            return Promise.resolve({ value, done: false });
+        }
+        if (this.failure !== null) return Promise.reject(this.failure);
+        if (this.complete) return Promise.resolve({ value: undefined, done: true });
+
+        return new Promise((resolve, reject) => {
+            this.waiting = resolve;
+            this.failWaiting = reject;
+        });
+    }
+
+    [Symbol.asyncIterator]() {
+        return this;
+    }
+}
@@ -1,9 +1,12 @@
 import FixedChunkedParser from "./FixedChunkedParser";
 import StreamingChunkedParser from "./StreamingChunkedParser";
+import NativeChunkedParser from "./NativeChunkedParser";
 import { UntilEndChunkedParser } from "./UntilEndChunkerParser";
 
 export interface ChunkParser {
     streaming: StreamingChunkedParser;
+    /** Buffered chunked bodies, null when the addon has no ChunkedDecoder. */
+    native: NativeChunkedParser | null;
     fixed: FixedChunkedParser;
     untilEnd: UntilEndChunkedParser;
 }
\ No newline at end of file
@@ -2,7 +2,31 @@ import { ChunkParser } from "./ChunkParser";
 import { Http } from "../../http";
 import FixedChunkedParser from "./FixedChunkedParser";
 import StreamingChunkedParser from "./StreamingChunkedParser";
+import NativeChunkedParser from "./NativeChunkedParser";
 import { UntilEndChunkedParser } from "./UntilEndChunkerParser";
+import { BodyStream } from "./BodyStream";
+import { HeaderView, createHeaderSpans } from "./HeaderView";
+import { hypernode } from "../../hypernode";
+
+/**
+ * Slot indexes of `ChunkProgression.resultSlots`.
+ * Must stay in the same order as ResultSlot in native/http/core/http_core.h.
+ */
+export const enum ResultSlot {
+    METHOD,
+    RET_FLAG,
+    MAIN_OFFSET,
+    HEADER_SIZE,
+    QUERY_START,
+    QUERY_LEN,
+    RESUME_STATE,
+    RESUME_HEADER,
+    RESUME_NAME_START,
+    RESUME_NAME_LEN,
+    RESUME_VALUE_START,
+    RESUME_SCAN_POS,
+    COUNT
+}
 
 class ChunkProgression {
     objId: number;
@@ -10,65 +34,159 @@ class ChunkProgression {
     chunkParser: ChunkParser;
     contentLen?: number;
     routePipe: any;
-    params: string[];
-    headers: Record<string, string | Array<string>>;
-    query: any;
-    method: Http.HttpMethod;
-    headerSize: number;
-    mainOffset: number;
-    retFlag: number;
+    params: Array<string | number>;
+    headers: Record<string, string>;
+    headerSpans: Uint32Array;
+    resultSlots: Int32Array;
     rawBuf: Buffer;
+    headerBuf: Buffer;
+    scratch: Buffer;
     writeOffset: number;
+    pipelined: Buffer | null;
+    feeding: boolean;
+    bodyStream: BodyStream | null;
 
+    private headerView: HeaderView;
+    private parsedQuery: any;
     private respCpool: any;
     private cPool: any;
     private parseInitial: any;
     
-    constructor(cPool: any, parseInitial: Function, respCpool: any, rawBufferSize: number) {
+    constructor(cPool: any, parseInitial: Function, respCpool: any, headerBufferSize: number) {
         this.cPool = cPool;
+        this.resultSlots = new Int32Array(ResultSlot.COUNT);
         this.fn = parseInitial;
         this.chunkParser = {
             streaming: new StreamingChunkedParser(),
+            native: hypernode.ChunkedDecoder ? new NativeChunkedParser() : null,
             fixed: new FixedChunkedParser(),
             untilEnd: new UntilEndChunkedParser()
         };
         this.contentLen = undefined;
         this.routePipe = null;
         this.params = [];
-        this.headers = {};
-        this.query = {};
+        this.headerSpans = createHeaderSpans();
+        this.headerView = new HeaderView(this);
+        this.headers = this.headerView.headers;
+        this.parsedQuery = undefined;
         this.method = Http.HttpMethod.GET;
         this.headerSize = 0;
         this.mainOffset = 0;
         this.writeOffset = 0;
+        this.pipelined = null;
+        this.feeding = false;
+        this.bodyStream = null;
         this.retFlag = Http.RetFlagBits.FLAG_OK;
-        this.rawBuf = Buffer.allocUnsafe(rawBufferSize);
-        this.objId = cPool.registerObj(this);
+        this.headerBuf = Buffer.allocUnsafe(headerBufferSize);
+        this.scratch = Buffer.allocUnsafe(headerBufferSize);
+        this.rawBuf = this.headerBuf;
+        // Registered in bulk by the context, see HttpContext.registerAll.
+        this.objId = -1;
         this.respCpool = respCpool;
         this.parseInitial = parseInitial;
     }
 
+    get method(): Http.HttpMethod { return this.resultSlots[ResultSlot.METHOD]; }
+    set method(v: Http.HttpMethod) { this.resultSlots[ResultSlot.METHOD] = v; }
+
+    get retFlag(): number { return this.resultSlots[ResultSlot.RET_FLAG]; }
+    set retFlag(v: number) { this.resultSlots[ResultSlot.RET_FLAG] = v; }
+
+    get mainOffset(): number { return this.resultSlots[ResultSlot.MAIN_OFFSET]; }
+    set mainOffset(v: number) { this.resultSlots[ResultSlot.MAIN_OFFSET] = v; }
+
+    get headerSize(): number { return this.resultSlots[ResultSlot.HEADER_SIZE]; }
+    set headerSize(v: number) { this.resultSlots[ResultSlot.HEADER_SIZE] = v; }
+
+    /**
+     * The scanner only records where the query string is, it is decoded
+     * from `rawBuf` on first access.
+     */
+    get query(): any {
+        if (this.parsedQuery === undefined) {
+            const len = this.resultSlots[ResultSlot.QUERY_LEN];
+            this.parsedQuery = len === 0
+                ? {}
+                : hypernode.parseQuery(this.rawBuf, this.resultSlots[ResultSlot.QUERY_START], len, this.scratch);
+        }
+        return this.parsedQuery;
+    }
+    set query(v: any) { this.parsedQuery = v; }
+
     allocateResp() {
         let ret = this.respCpool.allocate();
         return ret;
     }
 
+    /**
+     * Span and slot offsets stay valid because the block always starts at
+     * offset 0 of the scanned buffer. Only the chunk that completes an
+     * oversized block (e.g. headers plus body) falls back to a concat.
+     */
+    appendHeaderChunk(chunk: Buffer): Buffer {
+        const end = this.writeOffset + chunk.length;
+        if (end <= this.headerBuf.length) {
+            chunk.copy(this.headerBuf, this.writeOffset);
+            this.rawBuf = this.headerBuf.subarray(0, end);
+        } else {
+            this.rawBuf = Buffer.concat([this.rawBuf.subarray(0, this.writeOffset), chunk], end);
+        }
+        this.writeOffset = end;
+        return this.rawBuf;
+    }
+
+    /**
+     * Takes the body slab of the request being answered. `req.body`, and a
+     * response body that reuses it, point into it until the response has
+     * been flushed, so the caller releases it from the write callback
+     * instead of letting `reset()` hand it to the next request.
+     */
+    detachBodySlab(): Buffer | null {
+        // A request fills at most one of them.
+        const fixed = this.chunkParser.fixed.detach();
+        const native = this.chunkParser.native?.detach() ?? null;
+        return fixed ?? native;
+    }
+
+    headerOverflow(): boolean {
+        return this.writeOffset >= this.headerBuf.length;
+    }
+
     reset() {
         this.fn = this.parseInitial;
         this.contentLen = undefined;
         this.routePipe = null;
         this.params = [];
-        this.headers = {};
-        this.query = {};
+        this.headerSpans[0] = 0;
+        this.headerView.reset();
+        this.parsedQuery = undefined;
+        this.resultSlots[ResultSlot.QUERY_LEN] = 0;
+        this.resultSlots[ResultSlot.RESUME_STATE] = 0;
         this.method = Http.HttpMethod.GET;
         this.headerSize = 0;
         this.mainOffset = 0;
         this.retFlag = Http.RetFlagBits.FLAG_OK;
         this.writeOffset = 0;
+        this.rawBuf = this.headerBuf;
+        this.bodyStream = null;
+        this.chunkParser.fixed.free();
+        this.chunkParser.native?.free();
     }
 
     free() {
+        // A streaming handler still reading the body must not wait forever.
+        this.bodyStream?.abort(new Error("Connection closed before the request body was complete"));
+        this.chunkParser.streaming.setSink(null);
+        // routePipe is only cleared once the response is out. Until then an
+        // async handler may still read req.body, a view into the slabs, so
+        // they are left to the GC instead of going back to the free list.
+        if (this.routePipe !== null) {
+            this.chunkParser.fixed.drop();
+            this.chunkParser.native?.drop();
+        }
         this.reset();
+        this.chunkParser.fixed.release();
+        this.chunkParser.native?.release();
         this.cPool.free(this.objId);
     }
 }
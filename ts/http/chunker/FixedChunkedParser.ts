@@ -1,5 +1,18 @@
+import { acquireSlab, releaseSlab, RETAINED_SLAB_SIZE } from "./BodySlab";
+
+/**
+ * Collects a Content-Length body into the connection's body slab.
+ *
+ * The slab is taken from the shared size classes on the first body that
+ * needs it, swapped for a bigger class when a body does not fit and kept
+ * across keep-alive requests while it is no larger than RETAINED_SLAB_SIZE.
+ * `getBody()` is therefore a view that is only valid until the response of
+ * the request has been sent; a response that may still reference it takes
+ * the slab along with `detach()` and releases it once flushed.
+ */
 class FixedChunkedParser {
     private buffer: Buffer | null = null;
+    private slab: Buffer | null = null;
     private writeCursor: number = 0;
     private expectedLength: number = 0;
 
@@ -11,8 +24,12 @@ class FixedChunkedParser {
             this.expectedLength = 0;
             return;
         }
+        if (this.slab === null || this.slab.length < size) {
+            if (this.slab !== null) releaseSlab(this.slab);
+            this.slab = acquireSlab(size);
+        }
         this.expectedLength = size;
-        this.buffer = Buffer.allocUnsafe(size);
+        this.buffer = this.slab.subarray(0, size);
         this.writeCursor = 0;
     }
 
@@ -52,6 +69,27 @@ class FixedChunkedParser {
         this.buffer = null;
         this.writeCursor = 0;
         this.expectedLength = 0;
+        if (this.slab !== null && this.slab.length > RETAINED_SLAB_SIZE) this.release();
+    }
+
+    /** Gives the slab back to the shared free list, e.g. when the connection closes. */
+    release(): void {
+        if (this.slab !== null) releaseSlab(this.slab);
+        this.slab = null;
+    }
+
+    /** Hands the slab over to the caller, who releases it once nothing references it any more. */
+    detach(): Buffer | null {
+        const slab = this.slab;
+        this.buffer = null;
+        this.slab = null;
+        return slab;
+    }
+
+    /** Lets go of the slab without recycling it, for when a handler may still hold a view of it. */
+    drop(): void {
+        this.buffer = null;
+        this.slab = null;
     }
 }
 
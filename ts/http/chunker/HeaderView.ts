@@ -0,0 +1,178 @@
+/**
+ * Layout of the per-connection header span table filled by the native
+ * scanner (see HEADER_SPAN_* in native/http/core/http_scanner.h).
+ *
+ * Slot 0 holds the number of committed headers, followed by tuples of
+ * (HeaderId | flags, nameStart, nameLen, valueStart, valueLen).
+ */
+export const HEADER_SPAN_CAPACITY = 256;
+export const HEADER_SPAN_HEAD = 1;
+export const HEADER_SPAN_STRIDE = 5;
+
+const HEADER_SPAN_ID_MASK = 0xFFFF;
+const HEADER_SPAN_MERGEABLE = 1 << 16;
+const HDR_UNKNOWN = 0;
+
+/**
+ * Lowercase header names indexed by native HeaderId.
+ * Must stay in the same order as HttpScanner::HEADERS.
+ */
+const HEADER_NAMES = [
+    "unknown",
+
+    // SINGLETON
+    "host", "content-length", "transfer-encoding", "content-type", "content-range",
+    "authorization", "proxy-authorization", "user-agent", "range", "expect",
+    "if-match", "if-none-match", "if-modified-since", "if-unmodified-since",
+    "referer", "origin", "date",
+
+    // MULTI
+    "set-cookie", "warning", "www-authenticate", "proxy-authenticate", "link", "via",
+
+    // MERGEABLE
+    "accept", "accept-language", "accept-encoding", "accept-ranges", "allow",
+    "cache-control", "connection", "pragma", "upgrade", "trailer", "te", "vary",
+
+    // NORMAL / KNOWN
+    "cookie", "etag", "last-modified", "expires", "server", "location",
+
+    // Security / Fetch
+    "referer-policy", "sec-fetch-site", "sec-fetch-mode", "sec-fetch-dest",
+    "sec-fetch-user", "dnt",
+
+    // Proxy / Forwarding
+    "x-forwarded-for", "x-forwarded-proto", "x-forwarded-host", "x-real-ip"
+];
+
+const HEADER_IDS: Record<string, number> = Object.create(null);
+for (let i = 1; i < HEADER_NAMES.length; i++) HEADER_IDS[HEADER_NAMES[i]] = i;
+
+export interface HeaderViewSource {
+    rawBuf: Buffer;
+    headerSpans: Uint32Array;
+}
+
+export function createHeaderSpans(): Uint32Array {
+    return new Uint32Array(HEADER_SPAN_HEAD + HEADER_SPAN_CAPACITY * HEADER_SPAN_STRIDE);
+}
+
+function nameEquals(buf: Buffer, start: number, len: number, key: string): boolean {
+    if (len !== key.length) return false;
+    for (let i = 0; i < len; i++) {
+        let c = buf[start + i];
+        if (c >= 65 && c <= 90) c |= 0x20;
+        if (c !== key.charCodeAt(i)) return false;
+    }
+    return true;
+}
+
+/**
+ * Lazy, read-mostly view over the native header span table.
+ *
+ * Strings are only created for the headers a handler actually reads and are
+ * cached until `reset()`. Repeated mergeable headers are joined with ", " and
+ * other repeats keep the last value, matching the object scan mode.
+ */
+export class HeaderView {
+    readonly headers: Record<string, string>;
+
+    private src: HeaderViewSource;
+    private cache: Record<string, string | null>;
+
+    constructor(src: HeaderViewSource) {
+        this.src = src;
+        this.cache = Object.create(null);
+        this.headers = new Proxy(this, headerViewHandler) as unknown as Record<string, string>;
+    }
+
+    reset() {
+        this.cache = Object.create(null);
+    }
+
+    get(key: string): string | undefined {
+        let v = this.cache[key];
+        if (v === undefined) {
+            v = this.resolve(key);
+            this.cache[key] = v;
+        }
+        return v === null ? undefined : v;
+    }
+
+    set(key: string, value: string) {
+        this.cache[key] = value;
+    }
+
+    delete(key: string) {
+        this.cache[key] = null;
+    }
+
+    keys(): string[] {
+        const spans = this.src.headerSpans;
+        const buf = this.src.rawBuf;
+        const count = spans[0];
+        const seen: Record<string, true> = Object.create(null);
+        const out: string[] = [];
+
+        for (let i = 0, o = HEADER_SPAN_HEAD; i < count; i++, o += HEADER_SPAN_STRIDE) {
+            const id = spans[o] & HEADER_SPAN_ID_MASK;
+            const name = id === HDR_UNKNOWN
+                ? buf.toString("latin1", spans[o + 1], spans[o + 1] + spans[o + 2]).toLowerCase()
+                : HEADER_NAMES[id];
+            if (!seen[name]) {
+                seen[name] = true;
+                if (this.get(name) !== undefined) out.push(name);
+            }
+        }
+
+        for (const k in this.cache) {
+            if (!seen[k] && this.cache[k] !== null) out.push(k);
+        }
+
+        return out;
+    }
+
+    private resolve(key: string): string | null {
+        const spans = this.src.headerSpans;
+        const buf = this.src.rawBuf;
+        const count = spans[0];
+        const id = HEADER_IDS[key] ?? HDR_UNKNOWN;
+        let out: string | null = null;
+
+        for (let i = 0, o = HEADER_SPAN_HEAD; i < count; i++, o += HEADER_SPAN_STRIDE) {
+            const tag = spans[o];
+            if ((tag & HEADER_SPAN_ID_MASK) !== id) continue;
+            if (id === HDR_UNKNOWN && !nameEquals(buf, spans[o + 1], spans[o + 2], key)) continue;
+
+            const v = buf.toString("latin1", spans[o + 3], spans[o + 3] + spans[o + 4]);
+            out = (out !== null && (tag & HEADER_SPAN_MERGEABLE)) ? out + ", " + v : v;
+        }
+
+        return out;
+    }
+}
+
+const headerViewHandler: ProxyHandler<HeaderView> = {
+    get(view, key) {
+        return typeof key === "string" ? view.get(key) : undefined;
+    },
+    set(view, key, value) {
+        if (typeof key === "string") view.set(key, value);
+        return true;
+    },
+    has(view, key) {
+        return typeof key === "string" && view.get(key) !== undefined;
+    },
+    deleteProperty(view, key) {
+        if (typeof key === "string") view.delete(key);
+        return true;
+    },
+    ownKeys(view) {
+        return view.keys();
+    },
+    getOwnPropertyDescriptor(view, key) {
+        if (typeof key !== "string") return undefined;
+        const value = view.get(key);
+        if (value === undefined) return undefined;
+        return { value, writable: true, enumerable: true, configurable: true };
+    }
+};
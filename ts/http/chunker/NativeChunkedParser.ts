@@ -0,0 +1,104 @@
+import { hypernode, IChunkedDecoder } from "../../hypernode";
+import { acquireSlab, releaseSlab, RETAINED_SLAB_SIZE, SLAB_CLASSES } from "./BodySlab";
+
+/**
+ * Results of `ChunkedDecoder.write`.
+ * Must stay in the same order as ChunkedDecoding::Status in native/http/core/chunked_decoder.h.
+ */
+export const enum ChunkedStatus {
+    MORE = 0,
+    DONE = 1,
+    DEST_FULL = 2,
+    ERR_SIZE = -1,
+    ERR_TOO_LARGE = -2,
+    ERR_EXTENSION = -3,
+    ERR_TRAILER = -4,
+    ERR_CRLF = -5
+}
+
+const EMPTY = Buffer.alloc(0);
+
+/**
+ * Buffered chunked bodies on top of the native `ChunkedDecoder`.
+ *
+ * Chunk data is compacted into the connection's body slab (see BodySlab),
+ * so the body is complete without a final concat. The slab is taken on the
+ * first chunked request, moved to the next size class when the decoder
+ * reports it full and kept for the next requests while it is no larger than
+ * RETAINED_SLAB_SIZE. `getBody()` is a view into it that is only valid until
+ * the response of the request has been sent, see `detach()`.
+ */
+class NativeChunkedParser {
+    private decoder: IChunkedDecoder;
+    private dest: Buffer = EMPTY;
+    private maxContentSize: number = 0;
+    private rest: Buffer | null = null;
+
+    constructor() {
+        this.decoder = new hypernode.ChunkedDecoder!();
+    }
+
+    begin(maxContentSize: number): void {
+        this.decoder.reset(maxContentSize);
+        this.maxContentSize = maxContentSize;
+        this.rest = null;
+    }
+
+    write(chunk: Buffer): ChunkedStatus {
+        let status: ChunkedStatus = this.decoder.write(chunk, this.dest);
+        while (status === ChunkedStatus.DEST_FULL) {
+            chunk = chunk.subarray(this.decoder.consumed());
+            this.grow();
+            status = this.decoder.write(chunk, this.dest);
+        }
+        if (status === ChunkedStatus.DONE) {
+            this.rest = chunk.subarray(this.decoder.consumed());
+        }
+        return status;
+    }
+
+    getBody(): Buffer {
+        return this.dest.subarray(0, this.decoder.length());
+    }
+
+    /** Bytes after the terminating CRLF in the last chunk, the next pipelined request. */
+    getRest(): Buffer | null {
+        return this.rest;
+    }
+
+    free(): void {
+        this.rest = null;
+        if (this.dest.length > RETAINED_SLAB_SIZE) this.release();
+    }
+
+    /** Gives the slab back to the shared free list, e.g. when the connection closes. */
+    release(): void {
+        if (this.dest !== EMPTY) releaseSlab(this.dest);
+        this.dest = EMPTY;
+    }
+
+    /** Hands the slab over to the caller, who releases it once nothing references it any more. */
+    detach(): Buffer | null {
+        const dest = this.dest;
+        this.dest = EMPTY;
+        return dest === EMPTY ? null : dest;
+    }
+
+    /** Lets go of the slab without recycling it, for when a handler may still hold a view of it. */
+    drop(): void {
+        this.dest = EMPTY;
+    }
+
+    private grow() {
+        const len = this.decoder.length();
+        // Next size class up, then doubling past the biggest class. The
+        // decoder never writes past maxContentSize.
+        const want = this.dest.length < SLAB_CLASSES[SLAB_CLASSES.length - 1] ? this.dest.length + 1 : this.dest.length * 2;
+        const next = acquireSlab(Math.min(want, Math.max(this.maxContentSize, len + 1)));
+        this.dest.copy(next, 0, 0, len);
+        this.release();
+        this.dest = next;
+    }
+}
+
+export default NativeChunkedParser;
@@ -12,9 +12,19 @@ class StreamingChunkedParser {
     private expected: number = 0;
     private bodyParts: Buffer[] = [];
     private totalSize: number = 0;
+    private sink: ((slice: Buffer) => void) | null = null;
 
     constructor() {}
 
+    /**
+     * Pass-through mode for streaming endpoints: chunk data is handed to
+     * `sink` as soon as it arrives instead of being collected for `getBody()`.
+     * Only an incomplete size line or CRLF is carried over between writes.
+     */
+    setSink(sink: ((slice: Buffer) => void) | null): void {
+        this.sink = sink;
+    }
+
     write(data: Buffer): void {
         let currentBuffer: Buffer;
         
@@ -30,8 +40,6 @@ class StreamingChunkedParser {
         
         // 2. State Machine (Sadece currentBuffer üzerinde ilerler)
         while (readIndex < writeIndex && this.state !== StreamingChunkedState.FINISHED) {
-            const available = writeIndex - readIndex;
-
             if (this.state === StreamingChunkedState.READ_SIZE) {
                 // Sadece mevcut Buffer'ın sınırı içinde \r\n ara
                 const idx = currentBuffer.indexOf('\r\n', readIndex);
@@ -53,21 +61,24 @@ class StreamingChunkedParser {
             }
 
             if (this.state === StreamingChunkedState.READ_DATA) {
-                if (available < this.expected) break;
-
-                const chunk = currentBuffer.subarray(readIndex, readIndex + this.expected);
-                this.bodyParts.push(chunk);
-                this.totalSize += chunk.length;
-
-                readIndex += this.expected;
+                // Chunk data is emitted as far as it has arrived, so a large
+                // chunk is never buffered whole.
+                const n = Math.min(writeIndex - readIndex, this.expected);
+                const chunk = currentBuffer.subarray(readIndex, readIndex + n);
+                if (this.sink !== null) this.sink(chunk);
+                else this.bodyParts.push(chunk);
+                this.totalSize += n;
+
+                readIndex += n;
+                this.expected -= n;
+                if (this.expected > 0) break;
                 this.state = StreamingChunkedState.READ_CRLF;
             }
 
             if (this.state === StreamingChunkedState.READ_CRLF) {
-                if (available < 2) break;
+                if (writeIndex - readIndex < 2) break;
 
                 readIndex += 2;
-                this.expected = 0;
                 this.state = StreamingChunkedState.READ_SIZE;
             }
         }
@@ -105,6 +116,7 @@ class StreamingChunkedParser {
         this.expected = 0;
         this.bodyParts.length = 0;
         this.totalSize = 0;
+        this.sink = null;
     }
 }
 
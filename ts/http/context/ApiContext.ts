@@ -2,6 +2,7 @@ import { contentParserTable } from "../content/parser";
 import { contentDecodingTable, contentEncodingTable } from "../content/encoding";
 import { Http } from "../../http";
 import HttpContext from "./HttpContext";
+import { feedSocket } from "../factory/accumulator";
 import net from "net";
 
 class ApiContext extends HttpContext {
@@ -31,7 +32,7 @@ class ApiContext extends HttpContext {
             // socket.setKeepAlive(true, 60000);
     
             socket.on("data", chunk => {
-                p.fn(socket, chunk, p);
+                feedSocket(socket, chunk, p);
             });
             
             socket.on("timeout", () => {
@@ -56,7 +57,8 @@ class ApiContext extends HttpContext {
         const routeId = this.httpCore.scannerRouteFirst(
             chunk, p, 
             this.state.maxHeaderNameSize, this.state.maxHeaderValueSize, 
-            this.state.maxHeaderSize, this.state.requestQuerySize
+            this.state.maxHeaderSize, this.state.requestQuerySize,
+            p.headerSpans, p.resultSlots, p.scratch
         );
         if (p.retFlag !== Http.RetFlagBits.FLAG_OK) {
             switch (p.retFlag) {
@@ -69,19 +71,19 @@ class ApiContext extends HttpContext {
                             "Content-Length: 0\r\n\r\n"
                         )
                     );
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 // --- VERSION UNSUPPORTED ---
                 case Http.RetFlagBits.FLAG_HTTP_VERSION_UNSUPPORTED:
                     socket.write(this.errorRespMap.RESP_505);
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 // --- METHOD NOT ALLOWED ---
                 case Http.RetFlagBits.FLAG_METHOD_NOT_ALLOWED:
                     socket.write(this.errorRespMap.RESP_405);
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 // --- REQUEST QUERY EXCEEDED ---
@@ -99,7 +101,7 @@ class ApiContext extends HttpContext {
                     } else {
                         socket.write(this.errorRespMap.RESP_404);
                     }
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 // === HEADER ERRORS ===
@@ -112,12 +114,12 @@ class ApiContext extends HttpContext {
                 case Http.RetFlagBits.FLAG_MAX_HEADER_VALUE_SIZE:
                 case Http.RetFlagBits.FLAG_DUPLICATE_SINGLE_HEADER:
                     socket.write(this.errorRespMap.RESP_400);
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 case Http.RetFlagBits.FLAG_UNTERMINATED_HEADERS:
-                    chunk.copy(p.rawBuf, 0);
-                    p.writeOffset = chunk.length;
+                    p.writeOffset = 0;
+                    p.appendHeaderChunk(chunk);
                     p.routePipe = this.routePipes[routeId];
                     p.fn = this.parseHeader;
                     return; 
@@ -125,7 +127,7 @@ class ApiContext extends HttpContext {
                 // --- OTHER (fallback) ---
                 default:
                     socket.write(this.errorRespMap.RESP_400);
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
             }
         }
@@ -137,7 +139,7 @@ class ApiContext extends HttpContext {
 
         if (!hostHeader) {
             socket.write(this.errorRespMap.RESP_400);
-            socket.destroy();
+            socket.destroySoon();
             return;
         }
         
@@ -151,10 +153,9 @@ class ApiContext extends HttpContext {
         chunk,
         p
     ) => {
-        chunk.copy(p.rawBuf, p.writeOffset);
-        p.writeOffset += chunk.length;
-        this.httpCore.scannerHeader(p.rawBuf, p, this.state.maxHeaderNameSize, this.state.maxHeaderValueSize, 
-            this.state.maxHeaderSize);
+        const buf = p.appendHeaderChunk(chunk);
+        this.httpCore.scannerHeader(buf, p, this.state.maxHeaderNameSize, this.state.maxHeaderValueSize, 
+            this.state.maxHeaderSize, p.headerSpans, p.resultSlots, p.scratch);
         if (p.retFlag !== Http.RetFlagBits.FLAG_OK) {
             switch (p.retFlag) {
                 case Http.RetFlagBits.FLAG_INVALID_ARGUMENT:
@@ -168,6 +169,10 @@ class ApiContext extends HttpContext {
                     socket.destroySoon();
                     return;
                 case Http.RetFlagBits.FLAG_UNTERMINATED_HEADERS:
+                    if (p.headerOverflow()) {
+                        socket.write(this.errorRespMap.RESP_400);
+                        socket.destroySoon();
+                    }
                     return; 
             }
         }
@@ -176,7 +181,7 @@ class ApiContext extends HttpContext {
 
         if (!hostHeader) {
             socket.write(this.errorRespMap.RESP_400);
-            return socket.destroy();
+            return socket.destroySoon();
         }
         
         p.routePipe.accumulateHandler(socket, p);
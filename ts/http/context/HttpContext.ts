@@ -2,9 +2,11 @@ import { Http } from "../../http";
 import { hypernode, type IHttpCore, type ICPool } from "../../hypernode";
 import net from "net";
 import { PipeResponseBase } from "../response/PipeResponseBase";
+import { dateHeader, onDateHeader } from "../response/HttpDate";
 import ChunkProgression from "../chunker/ChunkProgression";
 import { createAccumulators } from "../factory/accumulator";
 import { RouteBuilder } from "../factory/route";
+import { SharedCPool } from "./SharedCPool";
 
 abstract class HttpContext implements Http.HttpContext {
     protected MODE!: "web" | "api";
@@ -12,15 +14,24 @@ abstract class HttpContext implements Http.HttpContext {
     protected abstract contentDecoding: Http.ContentDecoding;
     protected abstract contentEncoding: Http.ContentEncoding;
     protected abstract contentTypeParsers: Http.ContentTypeParser;
-    protected errorRespMap: Http.HttpStaticResponseMap = {
-        RESP_505: Buffer.from("HTTP/1.1 505 HTTP Version Not Supported\r\nContent-Length: 0\r\n\r\n"),
-        RESP_405: Buffer.from("HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\n\r\n"),
-        RESP_400: Buffer.from("HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n"),
-        RESP_404: Buffer.from("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n"),
-        RESP_413: Buffer.from("HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\n\r\n"),
-        RESP_414: Buffer.from("HTTP/1.1 414 Request-URI Too Large\r\nContent-Length: 0\r\n\r\n"),
-        RESP_204: Buffer.from("HTTP/1.1 204 No Content\r\n\r\n")
-    };  
+    /**
+     * Status line and rest of the head of every errorRespMap entry. The
+     * shared Date line is spliced in between once per second, so the
+     * entries stay plain prebuilt buffers.
+     */
+    private errorRespParts: Record<keyof Http.HttpStaticResponseMap, [Buffer, Buffer]> = {
+        RESP_505: [Buffer.from("HTTP/1.1 505 HTTP Version Not Supported\r\n"), Buffer.from("Content-Length: 0\r\n\r\n")],
+        RESP_405: [Buffer.from("HTTP/1.1 405 Method Not Allowed\r\n"), Buffer.from("Content-Length: 0\r\n\r\n")],
+        RESP_400: [Buffer.from("HTTP/1.1 400 Bad Request\r\n"), Buffer.from("Content-Length: 0\r\n\r\n")],
+        RESP_404: [Buffer.from("HTTP/1.1 404 Not Found\r\n"), Buffer.from("Content-Length: 0\r\n\r\n")],
+        RESP_413: [Buffer.from("HTTP/1.1 413 Payload Too Large\r\n"), Buffer.from("Content-Length: 0\r\n\r\n")],
+        RESP_414: [Buffer.from("HTTP/1.1 414 Request-URI Too Large\r\n"), Buffer.from("Content-Length: 0\r\n\r\n")],
+        RESP_503: [Buffer.from("HTTP/1.1 503 Service Unavailable\r\n"), Buffer.from("Content-Length: 0\r\n\r\n")],
+        RESP_204: [Buffer.from("HTTP/1.1 204 No Content\r\n"), Buffer.from("\r\n")]
+    };
+    protected errorRespMap = {} as Http.HttpStaticResponseMap;
+    /** Unsubscribes buildErrorRespMap from the Date refresh, null once the server closed. */
+    private stopDateHeader: (() => void) | null = null;
     
     public server!: net.Server;
 
@@ -59,39 +70,60 @@ abstract class HttpContext implements Http.HttpContext {
             ResponseCtor: opts?.ResponseCtor || PipeResponseBase
         }
 
+        this.stopDateHeader = onDateHeader(date => this.buildErrorRespMap(date));
+
         if (opts?.bootstrapPoolChunkProgression) {
             // @ts-ignore
             this.bootstrapPoolChunkProgressionFn = opts?.bootstrapPoolChunkProgression;
         }
     }
 
-    private setRegisterResp(n: number, cPool: any) {
+    private buildErrorRespMap(date: Buffer) {
+        const parts = this.errorRespParts;
+        let k: keyof Http.HttpStaticResponseMap;
+        for (k in parts) {
+            this.errorRespMap[k] = Buffer.concat([parts[k][0], date, parts[k][1]]);
+        }
+    }
+
+    /** One native call for the whole batch when the pool supports it. */
+    private static registerAll(cPool: ICPool, objs: object[]): ArrayLike<number> {
+        return cPool.registerMany ? cPool.registerMany(objs) : objs.map(obj => cPool.registerObj(obj));
+    }
+
+    private setRegisterResp(n: number, cPool: ICPool) {
+        const objs: PipeResponseBase[] = [];
         for (let i = 0; i < n; i++) {
-            let cObj = new this.state.ResponseCtor();
-            let objId = cPool.registerObj(cObj);
-            cObj.setCPool(cPool, objId);
+            objs.push(new this.state.ResponseCtor());
+        }
+        const ids = HttpContext.registerAll(cPool, objs);
+        for (let i = 0; i < n; i++) {
+            objs[i].setCPool(cPool, ids[i]);
         }
     }
 
-    private setRegisterChunkProgression(n: number, cPool: any, respCPool: any) {
+    private setRegisterChunkProgression(n: number, cPool: ICPool, respCPool: ICPool) {
         const objs: ChunkProgression[] = [];
-        const rawBufferSize = this.state.maxHeaderSize + this.state.requestQuerySize + this.state.maxContentSize;
+        const headerBufferSize = this.state.maxHeaderSize + this.state.requestQuerySize;
+        for (let i = 0; i < n; i++) {
+            objs.push(new ChunkProgression(cPool, this.parseInitial, respCPool, headerBufferSize));
+        }
+        const ids = HttpContext.registerAll(cPool, objs);
         for (let i = 0; i < n; i++) {
-            const cpObj = new ChunkProgression(cPool, this.parseInitial, respCPool, rawBufferSize);
+            objs[i].objId = ids[i];
             if (this.bootstrapPoolChunkProgressionFn) {
-                this.bootstrapPoolChunkProgressionFn(cpObj);
+                this.bootstrapPoolChunkProgressionFn(objs[i]);
             }
-            objs.push(cpObj);
         }
         return objs;
     }
 
     protected initRuntime() {
-        this.respPool = new hypernode.CPool();
+        this.respPool = SharedCPool.create();
         this.respPool.initializePool(this.state.maxRequests);
         this.setRegisterResp(this.state.maxRequests, this.respPool);
 
-        this.chunkPool = new hypernode.CPool();
+        this.chunkPool = SharedCPool.create();
         this.chunkPool.initializePool(this.state.maxRequests);
         this.setRegisterChunkProgression(
             this.state.maxRequests,
@@ -149,13 +181,14 @@ abstract class HttpContext implements Http.HttpContext {
         if (maxAge !== undefined)
             headers.push(`Access-Control-Max-Age: ${maxAge}`);
 
-        this.state.corsHeaders = headers.join("\n");
-        this.errorRespMap.RESP_204 = Buffer.from(
-                        "HTTP/1.1 404 Not Found\r\n" +
-                        this.state.corsHeaders + "\r\n" +
-                        "Content-Length: 0\r\n\r\n"
-                    );
+        this.state.corsHeaders = headers.join("\r\n");
+        this.errorRespParts.RESP_204 = [
+            Buffer.from("HTTP/1.1 404 Not Found\r\n"),
+            Buffer.from(this.state.corsHeaders + "\r\n" + "Content-Length: 0\r\n\r\n")
+        ];
+        this.buildErrorRespMap(dateHeader());
         this.isEnableCors = true;
+        this.routeBuilder?.refreshStaticHeaders(this.state);
 
         return this;
     }
@@ -190,6 +223,14 @@ abstract class HttpContext implements Http.HttpContext {
         backlog?: number | undefined,
         listeningListener?: (() => void) | undefined
     ) {
+        // The Date listener keeps this context reachable, drop it with the server.
+        if (this.stopDateHeader === null) {
+            this.stopDateHeader = onDateHeader(date => this.buildErrorRespMap(date));
+        }
+        this.server.once("close", () => {
+            this.stopDateHeader?.();
+            this.stopDateHeader = null;
+        });
         this.server.listen(port, hostname, backlog, listeningListener);
         return this;
     }
@@ -198,10 +239,17 @@ abstract class HttpContext implements Http.HttpContext {
         if (n < 1) {
             return false;
         }
+        const grown = n - this.state.maxRequests;
         this.state.maxRequests = n;
         try {
             this.chunkPool.resizePool(n);
             this.respPool.resizePool(n);
+            // New slots, and retired ones freed before a grow reclaimed
+            // them, are empty until objects are registered for them.
+            const respVacant = this.respPool.vacant?.() ?? Math.max(grown, 0);
+            const chunkVacant = this.chunkPool.vacant?.() ?? Math.max(grown, 0);
+            if (respVacant > 0) this.setRegisterResp(respVacant, this.respPool);
+            if (chunkVacant > 0) this.setRegisterChunkProgression(chunkVacant, this.chunkPool, this.respPool);
         } catch (error) {
             console.error(error);
             return false;
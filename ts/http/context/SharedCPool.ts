@@ -0,0 +1,147 @@
+import { hypernode, type ICPool } from "../../hypernode";
+
+/**
+ * Slot indexes of the Int32Array returned by `CPool.sharedState()`.
+ * Must stay in the same order as SharedSlot in native/http/cpool/cpool.h.
+ */
+export const enum SharedSlot {
+    FREE_TOP,
+    ACTIVE_SIZE,
+    CAPACITY,
+    HEADER
+}
+
+/**
+ * CPool whose `allocate()` and `free()` run in JS.
+ *
+ * The native pool keeps its free stack and in-use flags in an Int32Array
+ * (`[header][free stack: capacity][in-use: capacity]`), so the hot path is
+ * a few typed array reads and writes instead of an N-API call. Registration,
+ * resizing and the retired-zone bookkeeping of a shrink stay native; a free
+ * of a retired index is forwarded to it. The native side replaces the
+ * array when the pool grows, so it is fetched again after every resize.
+ *
+ * `objects` mirrors the native registrations: a retired entry is dropped
+ * when native unregisters it, that is when it is freed or when the shrink
+ * completes, never at resize time while it may still be in flight.
+ */
+export class SharedCPool implements ICPool {
+    private pool: ICPool;
+    private state: Int32Array = new Int32Array(SharedSlot.HEADER);
+    private objects: any[] = [];
+    /** Physical size of the native pool, retired zone included. */
+    private size = 0;
+    /** Retired slots still in use, the shrink completes when it reaches 0. */
+    private retiring = 0;
+
+    constructor(pool: ICPool) {
+        this.pool = pool;
+    }
+
+    /** A SharedCPool, or a plain native CPool if the addon has no shared state. */
+    static create(): ICPool {
+        const pool = new hypernode.CPool();
+        return typeof pool.sharedState === "function" ? new SharedCPool(pool) : pool;
+    }
+
+    initializePool(size: number): void {
+        this.pool.initializePool(size);
+        this.state = this.pool.sharedState!();
+        this.size = size;
+    }
+
+    registerObj(obj: object): number {
+        const id = this.pool.registerObj(obj);
+        this.objects[id] = obj;
+        return id;
+    }
+
+    registerMany(objs: object[]): Int32Array {
+        const ids = this.pool.registerMany
+            ? this.pool.registerMany(objs)
+            : Int32Array.from(objs, (obj) => this.pool.registerObj(obj));
+        for (let i = 0; i < ids.length; i++) this.objects[ids[i]] = objs[i];
+        return ids;
+    }
+
+    allocate(): any | null {
+        const s = this.state;
+        const top = s[SharedSlot.FREE_TOP];
+        if (top === 0) return null;
+
+        const idx = s[SharedSlot.HEADER + top - 1];
+        const obj = this.objects[idx];
+        // An unregistered slot stays free rather than being handed out empty.
+        if (obj === undefined) return null;
+
+        s[SharedSlot.FREE_TOP] = top - 1;
+        s[SharedSlot.HEADER + s[SharedSlot.CAPACITY] + idx] = 1;
+        return obj;
+    }
+
+    free(index: number): void {
+        const s = this.state;
+        if (index < 0 || index >= s[SharedSlot.ACTIVE_SIZE]) {
+            // Retired slot of a pending shrink, or out of range.
+            const inUse = index >= 0 && index < this.size
+                && s[SharedSlot.HEADER + s[SharedSlot.CAPACITY] + index] === 1;
+            this.pool.free(index);
+            if (inUse) this.unregisterRetired(index);
+            return;
+        }
+
+        const flag = SharedSlot.HEADER + s[SharedSlot.CAPACITY] + index;
+        if (s[flag] === 0) return; // double free
+        s[flag] = 0;
+        s[SharedSlot.HEADER + s[SharedSlot.FREE_TOP]++] = index;
+    }
+
+    resizePool(newSize: number): void {
+        const s = this.state;
+        const active = s[SharedSlot.ACTIVE_SIZE];
+        let inFlight = 0;
+        if (newSize < this.size) {
+            const flags = SharedSlot.HEADER + s[SharedSlot.CAPACITY];
+            for (let i = newSize; i < this.size; i++) inFlight += s[flags + i];
+        }
+
+        this.pool.resizePool(newSize);
+        this.state = this.pool.sharedState!();
+        if (newSize === active) return;
+
+        if (newSize > this.size) {
+            this.size = newSize;
+        } else if (inFlight === 0) {
+            // Same rule as native: with nothing in flight the retired zone is
+            // unregistered now, otherwise entry by entry as it is freed.
+            this.truncate(newSize);
+        } else {
+            this.retiring = inFlight;
+        }
+    }
+
+    /** Native unregistered a freed retired entry, and maybe the whole zone. */
+    private unregisterRetired(index: number): void {
+        this.objects[index] = undefined;
+        if (this.retiring > 0 && --this.retiring === 0) {
+            this.truncate(this.state[SharedSlot.ACTIVE_SIZE]);
+        }
+    }
+
+    private truncate(size: number): void {
+        if (this.objects.length > size) this.objects.length = size;
+        this.size = size;
+    }
+
+    vacant(): number {
+        let n = 0;
+        for (let i = 0; i < this.state[SharedSlot.ACTIVE_SIZE]; i++) {
+            if (this.objects[i] === undefined) n++;
+        }
+        return n;
+    }
+
+    sharedState(): Int32Array {
+        return this.state;
+    }
+}
@@ -2,11 +2,13 @@ import { contentParserTable } from "../content/parser";
 import { contentDecodingTable, contentEncodingTable } from "../content/encoding";
 import { Http } from "../../http";
 import HttpContext from "./HttpContext";
+import { feedSocket } from "../factory/accumulator";
 import * as Factory from "../factory/factory";
 import net from "net";
 import fs from "fs";
 import path from "path";
 import { hypernode, IPublicAssetParser } from "../../hypernode";
+import { dateHeader } from "../response/HttpDate";
 
 type RouteDefinationFn = (
     socket: net.Socket,
@@ -19,9 +21,25 @@ type CacheEntry = {
     headers: Buffer;
     body: Buffer;
     payload: Buffer;
+    /** `payload` without its status line, the Date header goes in between. */
+    tail: Buffer;
     size: number
 }
 
+const STATUS_OK = Buffer.from("HTTP/1.1 200 OK\r\n");
+
+/**
+ * Writes a cached 200 response with the current Date header spliced in
+ * after the status line, so the cached buffer itself never changes.
+ */
+function writeDated(socket: net.Socket, tail: Buffer) {
+    socket.cork();
+    socket.write(STATUS_OK);
+    socket.write(dateHeader());
+    socket.write(tail);
+    socket.uncork();
+}
+
 function isFingerprinted(name: string): boolean {
     return /\.[a-f0-9]{8,}\./i.test(name)
 }
@@ -52,6 +70,7 @@ class WebContext extends HttpContext {
 
     protected spaRootPath!: string;
     protected spaRespBuffer!: Buffer;
+    protected spaRespTail!: Buffer;
 
     private publicRoutePathName!: string;
     private publicStaticRoute!: string;
@@ -76,7 +95,7 @@ class WebContext extends HttpContext {
         }
 
         const __resp = Buffer.from(
-            "HTTP/1.1 200 OK\r\n" +
+            STATUS_OK.toString("latin1") +
             "Content-Type: text/html; charset=utf-8\r\n" +
             "Content-Length: " + _data!.length + "\r\n" +
             "Cache-Control: no-cache\r\n" +
@@ -88,6 +107,7 @@ class WebContext extends HttpContext {
         this.setAllAssets();
 
         this.spaRespBuffer = Buffer.concat([__resp, _data!]);
+        this.spaRespTail = this.spaRespBuffer.subarray(STATUS_OK.length);
 
         this.initRuntime();
         this.bindServer(opts?.netServerOptions);
@@ -105,7 +125,7 @@ class WebContext extends HttpContext {
             // socket.setNoDelay(true);
     
             socket.on("data", chunk => {
-                p.fn(socket, chunk, p);
+                feedSocket(socket, chunk, p);
             });
             
             socket.on("timeout", () => {
@@ -129,7 +149,8 @@ class WebContext extends HttpContext {
     ) => {
         const routeId = this.httpCore.scannerRouteFirst(
             chunk, p, 
-            this.state.maxHeaderNameSize, this.state.maxHeaderValueSize, this.state.maxContentSize, this.state.requestQuerySize
+            this.state.maxHeaderNameSize, this.state.maxHeaderValueSize, this.state.maxContentSize, this.state.requestQuerySize,
+            p.headerSpans, p.resultSlots, p.scratch
         );
         if (p.retFlag !== Http.RetFlagBits.FLAG_OK) {
             switch (p.retFlag) {
@@ -142,19 +163,19 @@ class WebContext extends HttpContext {
                             "Content-Length: 0\r\n\r\n"
                         )
                     );
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 // --- VERSION UNSUPPORTED ---
                 case Http.RetFlagBits.FLAG_HTTP_VERSION_UNSUPPORTED:
                     socket.write(this.errorRespMap.RESP_505);
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 // --- METHOD NOT ALLOWED ---
                 case Http.RetFlagBits.FLAG_METHOD_NOT_ALLOWED:
                     socket.write(this.errorRespMap.RESP_405);
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 // --- REQUEST QUERY EXCEEDED ---
@@ -172,7 +193,7 @@ class WebContext extends HttpContext {
                     } else {
                         socket.write(this.errorRespMap.RESP_404);
                     }
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 // === HEADER ERRORS ===
@@ -185,11 +206,12 @@ class WebContext extends HttpContext {
                 case Http.RetFlagBits.FLAG_MAX_HEADER_VALUE_SIZE:
                 case Http.RetFlagBits.FLAG_DUPLICATE_SINGLE_HEADER:
                     socket.write(this.errorRespMap.RESP_400);
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
 
                 case Http.RetFlagBits.FLAG_UNTERMINATED_HEADERS:
-                    p.rawBuf = chunk;
+                    p.writeOffset = 0;
+                    p.appendHeaderChunk(chunk);
                     p.routePipe = this.routePipes[routeId];
                     p.fn = this.parseHeader;
                     return; 
@@ -197,7 +219,7 @@ class WebContext extends HttpContext {
                 // --- OTHER (fallback) ---
                 default:
                     socket.write(this.errorRespMap.RESP_400);
-                    socket.destroy();
+                    socket.destroySoon();
                     return;
             }
         }
@@ -214,9 +236,7 @@ class WebContext extends HttpContext {
         if (!entry) {
             entry = this.loadAsset(assetPath)
             if (!entry) {
-                socket.write(
-                    "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n"
-                )
+                socket.write(this.errorRespMap.RESP_404)
                 p.free()
                 socket.end()
                 return
@@ -225,14 +245,14 @@ class WebContext extends HttpContext {
             this.assetCache.set(assetPath, entry)
         }
 
-        socket.write(entry.payload);
+        writeDated(socket, entry.tail);
         p.reset();
         socket.end();
     }
 
     protected spaRouteDefinationFn: RouteDefinationFn = (socket, p, routeId, _) => {
         p.free();
-        socket.write(this.spaRespBuffer);
+        writeDated(socket, this.spaRespTail);
         // socket.end();
     }
 
@@ -244,7 +264,7 @@ class WebContext extends HttpContext {
 
         if (!hostHeader) {
             socket.write(this.errorRespMap.RESP_400);
-            socket.destroy();
+            socket.destroySoon();
             return;
         }
         
@@ -257,9 +277,9 @@ class WebContext extends HttpContext {
         chunk,
         p
     ) => {
-        p.rawBuf = Buffer.concat([p.rawBuf, chunk]);
-        this.httpCore.scannerHeader(p.rawBuf, p, 
-            this.state.maxHeaderNameSize, this.state.maxHeaderValueSize, this.state.maxContentSize);
+        const buf = p.appendHeaderChunk(chunk);
+        this.httpCore.scannerHeader(buf, p, 
+            this.state.maxHeaderNameSize, this.state.maxHeaderValueSize, this.state.maxContentSize, p.headerSpans, p.resultSlots, p.scratch);
         if (p.retFlag !== Http.RetFlagBits.FLAG_OK) {
             switch (p.retFlag) {
                 case Http.RetFlagBits.FLAG_INVALID_ARGUMENT:
@@ -273,10 +293,14 @@ class WebContext extends HttpContext {
                     socket.destroySoon();
                     return;
                 case Http.RetFlagBits.FLAG_UNTERMINATED_HEADERS:
+                    if (p.headerOverflow()) {
+                        socket.write(this.errorRespMap.RESP_400);
+                        socket.destroySoon();
+                    }
                     return; 
             }
         }
-        this.routeDefinationFns[p.routePipe!.routeId](socket, p, p.routePipe!.routeId, chunk);
+        this.routeDefinationFns[p.routePipe!.routeId](socket, p, p.routePipe!.routeId, buf);
     };
 
     override registerRouters(mainRoute: Http.Route | undefined, conf?: Http.SwaggerConfig) {
@@ -381,15 +405,16 @@ class WebContext extends HttpContext {
                 : "public, max-age=0, must-revalidate"
 
             const headers = Buffer.from(
-                "HTTP/1.1 200 OK\r\n" +
+                STATUS_OK.toString("latin1") +
                 `Content-Type: ${mime}\r\n` +
                 `Content-Length: ${size}\r\n` +
                 `Cache-Control: ${cacheControl}\r\n` +
                 "\r\n"
             )
             const payload = Buffer.concat([headers, body]);
+            const tail = payload.subarray(STATUS_OK.length);
 
-            return { headers, body, size, payload }
+            return { headers, body, size, payload, tail }
 
         } catch(err) {
             console.error("Asset load failed:", fullPath, err);
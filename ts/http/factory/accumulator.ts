@@ -1,5 +1,57 @@
 import { Http } from "../../http";
 import net from "net";
+import { BodyStream } from "../chunker/BodyStream";
+import { ChunkedStatus } from "../chunker/NativeChunkedParser";
+import { releaseSlab } from "../chunker/BodySlab";
+
+/**
+ * Entry point for socket `data` events. Runs `p.fn` over the chunk and, as
+ * long as a finished request leaves the next pipelined request behind it in
+ * the same buffer (`p.pipelined`), keeps dispatching from there. The socket
+ * is corked for the whole chunk, so every response produced synchronously
+ * goes out in one writev.
+ */
+export function feedSocket(socket: net.Socket, chunk: Buffer, p: Http.ChunkProgression) {
+    socket.cork();
+    p.feeding = true;
+
+    try {
+        let next: Buffer | null = chunk;
+        while (next !== null) {
+            p.pipelined = null;
+            p.fn(socket, next, p);
+            next = socket.writable ? p.pipelined : null;
+        }
+    } finally {
+        // A throwing handler must not leave the socket corked.
+        p.pipelined = null;
+        p.feeding = false;
+        socket.uncork();
+    }
+}
+
+/**
+ * Writes what `getResp()` produced. Header block and body arrive as separate
+ * buffers and are queued under a cork, so they leave as iovecs of one writev
+ * (together with any other response already corked in `feedSocket`) rather
+ * than being concatenated first.
+ *
+ * The buffers live in the response's pooled output slab, and a body may be
+ * a view of the request's body slab, so both are only released from
+ * `flushed`, the callback of the last write.
+ */
+function writeResp(socket: net.Socket, ret: Buffer | Buffer[], flushed: () => void) {
+    if (!Array.isArray(ret)) {
+        socket.write(ret, flushed);
+        return;
+    }
+
+    const last = ret.length - 1;
+    socket.cork();
+    for (let i = 0; i < last; i++) socket.write(ret[i]);
+    socket.write(ret[last], flushed);
+    socket.uncork();
+}
 
 export function createAccumulators(ctx: {
     contentTypeParsers: Http.ContentTypeParser;
@@ -12,16 +64,72 @@ export function createAccumulators(ctx: {
         errorRespMap
     } = ctx;
     
+    /**
+     * Writes a finished response and prepares the connection for the next
+     * request. `rest` holds the bytes that followed this request in the buffer
+     * it was parsed from; inside `feedSocket` they are queued, after an async
+     * handler they are fed straight away.
+     *
+     * Each response holds a pooled object until the socket has flushed it, so
+     * nothing more is parsed while the socket asks for a drain: a client that
+     * pipelines without reading would otherwise empty the response pool. A
+     * `res` of null means the pool was empty anyway, answered with 503.
+     */
+    function respond(
+        socket: net.Socket,
+        p: Http.ChunkProgression,
+        ret: Buffer | Buffer[] | null,
+        res: Http.IHttpResponseBase | null,
+        rest: Buffer | null
+    ) {
+        if (res === null) {
+            socket.write(errorRespMap.RESP_503);
+            socket.destroySoon();
+            return;
+        }
+
+        // p.reset() below would hand the body slab to the next request
+        // while the response may still be queued with a view of it.
+        const slab = p.detachBodySlab();
+        writeResp(socket, ret!, slab === null ? res.freeCPool : () => {
+            res.freeCPool();
+            releaseSlab(slab);
+        });
+        if (p.headers.connection == "close") {
+            socket.destroySoon();
+            return;
+        }
+
+        p.reset();
+        if (socket.writableNeedDrain) {
+            socket.once("drain", () => {
+                socket.resume();
+                if (rest !== null && rest.length !== 0) feedSocket(socket, rest, p);
+            });
+            return;
+        }
+        socket.resume();
+
+        if (rest === null || rest.length === 0) return;
+        if (p.feeding) p.pipelined = rest;
+        else feedSocket(socket, rest, p);
+    }
+
     function accumulatorHeadGet(socket: net.Socket, p: Http.ChunkProgression) {
+        // GET/HEAD routes never read a body, so a declared one would be
+        // parsed as the next pipelined request (CL.0 desync). Refuse it.
+        const h = p.headers;
+        const contentLenStr = h["content-length"] as string | undefined;
+        if (h["transfer-encoding"] !== undefined || (contentLenStr !== undefined && Number(contentLenStr) !== 0)) {
+            socket.write(errorRespMap.RESP_400);
+            socket.destroySoon();
+            return;
+        }
+
         socket.pause();
-        p.routePipe!.pipeHandler(p, p.routePipe!.mws, (ret: any) => {
-            socket.write(ret);
-            const con = p.headers.connection;
-            if (con == "close") socket.destroySoon();
-            else {
-                p.reset();
-                socket.resume();   
-            }
+        const rest = p.rawBuf.subarray(p.mainOffset);
+        p.routePipe!.pipeHandler(p, p.routePipe!.mws, (ret: Buffer | Buffer[] | null, res: Http.IHttpResponseBase | null) => {
+            respond(socket, p, ret, res, rest);
         });
     }
 
@@ -32,7 +140,7 @@ export function createAccumulators(ctx: {
 
         if (p.rawBuf.length + chunk.length > p.routePipe!.maxContentSize) {
             socket.write(errorRespMap.RESP_413);
-            socket.destroy();
+            socket.destroySoon();
             return;
         }
 
@@ -45,15 +153,19 @@ export function createAccumulators(ctx: {
     async function accumulateDef(socket: net.Socket, chunk: Buffer, p: Http.ChunkProgression) {
 
         const acc = p.chunkParser.fixed;
-        const progress = acc.getTotalWrittenSize() + chunk.length;
-        if (progress > p.contentLen!) {
-            socket.write(errorRespMap.RESP_400);
-            socket.destroy();
-            return;
+        const need = p.contentLen! - acc.getTotalWrittenSize();
+
+        // Bytes past the body belong to the next pipelined request.
+        let rest: Buffer | null = null;
+        if (chunk.length > need) {
+            rest = chunk.subarray(need);
+            chunk = chunk.subarray(0, need);
         }
+
+        const progress = acc.getTotalWrittenSize() + chunk.length;
         if (progress > p.routePipe!.maxContentSize) {
             socket.write(errorRespMap.RESP_413);
-            socket.destroy();
+            socket.destroySoon();
             return;
         }
 
@@ -62,20 +174,14 @@ export function createAccumulators(ctx: {
         if (progress === p.contentLen) {
             socket.pause();
 
+            // The body is a view into the connection's slab, respond()
+            // takes the slab along and releases it once the response is out.
             const b = acc.getBody();
-            acc.free();
 
             const ret = await p.routePipe!.pipeHandler(
                 b, p, contentTypeParsers, contentDecoding, p.routePipe!.mws, 
-                (ret: any) => {
-                    socket.write(ret);
-                    
-                    const con = p.headers.Connection;
-                    if (con == "close") socket.destroySoon();
-                    else {
-                        p.reset();
-                        socket.resume();
-                    }
+                (ret: Buffer | Buffer[] | null, res: Http.IHttpResponseBase | null) => {
+                    respond(socket, p, ret, res, rest);
                 }
             );
 
@@ -110,22 +216,185 @@ export function createAccumulators(ctx: {
             contentTypeParsers,
             contentDecoding,
             p.routePipe!.mws,
-            (ret: any) => {
-                socket.write(ret);
-                const con = p.headers.connection;
-                if (con == "close") socket.destroySoon();
-                else {
-                    p.reset();
-                    socket.resume();   
-                }
+            (ret: Buffer | Buffer[] | null, res: Http.IHttpResponseBase | null) => {
+                respond(socket, p, ret, res, null);
             }
         )
     }
 
+    // ==============================
+    // CHUNKED MODE, native decoder
+    // Size lines, extensions and trailers are validated natively and the
+    // data is compacted into one buffer; bytes after the terminating CRLF
+    // are the next pipelined request.
+    // ==============================
+    function accumulateChunkedNative(socket: net.Socket, chunk: Buffer, p: Http.ChunkProgression) {
+        const dec = p.chunkParser.native!;
+        const status = dec.write(chunk);
+        if (status === ChunkedStatus.MORE) return;
+
+        if (status < 0) {
+            socket.write(status === ChunkedStatus.ERR_TOO_LARGE ? errorRespMap.RESP_413 : errorRespMap.RESP_400);
+            socket.destroySoon();
+            return;
+        }
+
+        socket.pause();
+        const rest = dec.getRest();
+        p.routePipe!.pipeHandler(
+            dec.getBody(), p, contentTypeParsers, contentDecoding, p.routePipe!.mws,
+            (ret: Buffer | Buffer[] | null, res: Http.IHttpResponseBase | null) => {
+                respond(socket, p, ret, res, rest);
+            }
+        );
+    }
+
+    // ==============================
+    // STREAM MODE (EndpointOpt.stream)
+    // The framers below only find the body boundaries and hand slices of
+    // the socket chunks to p.bodyStream; nothing is copied or concatenated.
+    // ==============================
+    function pushSlice(socket: net.Socket, body: BodyStream, slice: Buffer) {
+        // Nobody is reading yet: stop the socket until the slice is taken.
+        if (slice.length !== 0 && !body.push(slice)) socket.pause();
+    }
+
+    function finishStream(socket: net.Socket, p: Http.ChunkProgression, rest: Buffer | null) {
+        // Hold the next request back until the response is out.
+        socket.pause();
+        p.bodyStream!.end(rest);
+    }
+
+    function abortStream(socket: net.Socket, p: Http.ChunkProgression, resp: Buffer) {
+        p.bodyStream!.abort(new Error("Request body rejected"));
+        p.chunkParser.streaming.setSink(null);
+        socket.write(resp);
+        socket.destroySoon();
+    }
+
+    function streamDef(socket: net.Socket, chunk: Buffer, p: Http.ChunkProgression) {
+        const body = p.bodyStream!;
+        const need = p.contentLen! - body.received;
+
+        let rest: Buffer | null = null;
+        if (chunk.length > need) {
+            rest = chunk.subarray(need);
+            chunk = chunk.subarray(0, need);
+        }
+
+        pushSlice(socket, body, chunk);
+        if (body.received === p.contentLen) finishStream(socket, p, rest);
+    }
+
+    function streamChunked(socket: net.Socket, chunk: Buffer, p: Http.ChunkProgression) {
+        const parser = p.chunkParser.streaming;
+        if ((parser.getTotalSize() as number) + chunk.length > p.routePipe!.maxContentSize) {
+            abortStream(socket, p, errorRespMap.RESP_413);
+            return;
+        }
+
+        parser.write(chunk);
+        if (!parser.isFinished()) return;
+
+        parser.free();
+        finishStream(socket, p, null);
+    }
+
+    function streamUntilEnd(socket: net.Socket, chunk: Buffer, p: Http.ChunkProgression) {
+        const body = p.bodyStream!;
+        if (body.received + chunk.length > p.routePipe!.maxContentSize) {
+            abortStream(socket, p, errorRespMap.RESP_413);
+            return;
+        }
+
+        pushSlice(socket, body, chunk);
+    }
+
+    /**
+     * Starts the pipeline right after the headers with a `BodyStream` as the
+     * body. The response goes out once the handler is done; if it is done
+     * before the body was read to the end, the unread rest cannot be skipped
+     * safely and the connection is closed after the response.
+     */
+    function startStream(
+        socket: net.Socket,
+        p: Http.ChunkProgression,
+        framer: Http.ParseInitialFn,
+        already: Buffer,
+        keepAlive: boolean
+    ) {
+        const body = new BodyStream(() => {
+            if (!body.complete) socket.resume();
+        });
+        p.bodyStream = body;
+        p.fn = framer;
+        framer(socket, already, p);
+        if (!socket.writable) return;
+
+        p.routePipe!.pipeHandler(
+            body, p, contentTypeParsers, contentDecoding, p.routePipe!.mws,
+            (ret: Buffer | Buffer[] | null, res: Http.IHttpResponseBase | null) => {
+                if (!socket.writable) {
+                    res?.freeCPool();
+                    return;
+                }
+                if (res === null) {
+                    abortStream(socket, p, errorRespMap.RESP_503);
+                    return;
+                }
+                if (keepAlive && body.complete) {
+                    respond(socket, p, ret, res, body.rest);
+                    return;
+                }
+                writeResp(socket, ret!, res.freeCPool);
+                socket.destroySoon();
+            }
+        );
+    }
+
+    function decisionStream(socket: net.Socket, p: Http.ChunkProgression) {
+        const h = p.headers;
+        const contentLenStr = h["content-length"] as string;
+        const already = p.rawBuf.subarray(p.mainOffset);
+
+        if (h["transfer-encoding"] === "chunked") {
+            p.chunkParser.streaming.setSink((slice: Buffer) => pushSlice(socket, p.bodyStream!, slice));
+            // The streaming parser does not report what follows the last
+            // chunk, so the connection is not reused after a chunked stream.
+            startStream(socket, p, streamChunked, already, false);
+            return;
+        }
+
+        if (!contentLenStr) {
+            if (!p.routePipe!.untilEnd) {
+                socket.write(errorRespMap.RESP_400);
+                socket.destroySoon();
+                return;
+            }
+            socket.once("end", () => p.bodyStream?.end());
+            startStream(socket, p, streamUntilEnd, already, false);
+            return;
+        }
+
+        p.contentLen = parseInt(contentLenStr);
+        if (p.contentLen > p.routePipe!.maxContentSize) {
+            socket.write(errorRespMap.RESP_413);
+            socket.destroySoon();
+            return;
+        }
+
+        startStream(socket, p, streamDef, already, true);
+    }
+
     // ==============================
     // DESICION ACCUMULATE AFTER HEADERS
     // ==============================
     function decisionAccumulate(socket: net.Socket, p: Http.ChunkProgression) {
+        if (p.routePipe!.stream) {
+            decisionStream(socket, p);
+            return;
+        }
+
         const h = p.headers;
         const transferEnc = h["transfer-encoding"];
         const contentLenStr = h["content-length"] as string;
@@ -134,6 +403,14 @@ export function createAccumulators(ctx: {
         // ───────────────────────────────────────────────
         if (transferEnc === "chunked") {
             const already = p.rawBuf.slice(p.mainOffset);
+            const dec = p.chunkParser.native;
+            if (dec !== null) {
+                dec.begin(p.routePipe!.maxContentSize);
+                p.fn = accumulateChunkedNative;
+                accumulateChunkedNative(socket, already, p);
+                return;
+            }
+
             p.fn = accumulateChunked;
             // İlk chunk'ı senkron olarak işle
             accumulateChunked(socket, already, p);
@@ -151,7 +428,8 @@ export function createAccumulators(ctx: {
             }
             socket.on("end", () => {
                 const b = p.chunkParser.untilEnd.getBody();
-                p.routePipe!.pipeHandler(b, p, contentTypeParsers, contentDecoding, p.routePipe!.mws, () => {
+                p.routePipe!.pipeHandler(b, p, contentTypeParsers, contentDecoding, p.routePipe!.mws, (ret: Buffer | Buffer[] | null, res: Http.IHttpResponseBase | null) => {
+                    res?.freeCPool();
                     p.chunkParser.untilEnd.free();
                     socket.destroy();
                     return;
@@ -166,59 +444,37 @@ export function createAccumulators(ctx: {
         // ───────────────────────────────────────────────
         p.contentLen = parseInt(contentLenStr);
 
+        const already = p.rawBuf.slice(p.mainOffset);
+
         // Empty body
         if (p.contentLen === 0) {
             socket.pause();
             p.routePipe!.pipeHandler(
                 null, p, contentTypeParsers, contentDecoding, p.routePipe!.mws,
-                (ret: any) => {
-                    socket.write(ret);
-
-                    const con = h.connection;
-                    if (con == "close") socket.destroySoon();
-                    else {
-                        p.reset();
-                        socket.resume();
-                    }
+                (ret: Buffer | Buffer[] | null, res: Http.IHttpResponseBase | null) => {
+                    respond(socket, p, ret, res, already);
                 }
             )
             
             return;
         }
 
-        const already = p.rawBuf.slice(p.mainOffset);
-
         // ───────────────────────────────────────────────
-        // exact match (body fully arrived)
+        // body fully arrived, anything after it is the
+        // next pipelined request
         // ───────────────────────────────────────────────
-        if (already.length === p.contentLen) {
-            // socket.pause();
+        if (already.length >= p.contentLen) {
+            socket.pause();
+            const rest = already.subarray(p.contentLen);
             p.routePipe!.pipeHandler(
-                already, p, contentTypeParsers, contentDecoding, p.routePipe!.mws, (ret: any) => {
-                    const writeRet = socket.write(ret);
-
-                    if (h.connection == "close") {
-                        socket.destroySoon();
-                    }
-                    else {
-                        p.reset();
-                        socket.resume();
-                    }
+                already.subarray(0, p.contentLen), p, contentTypeParsers, contentDecoding, p.routePipe!.mws, (ret: Buffer | Buffer[] | null, res: Http.IHttpResponseBase | null) => {
+                    respond(socket, p, ret, res, rest);
                 }
             )
 
             return;
         }
 
-        // ───────────────────────────────────────────────
-        // overflow attempt → reject immediately
-        // ───────────────────────────────────────────────
-        if (already.length > p.contentLen) {
-            socket.write(errorRespMap.RESP_400);
-            socket.destroySoon();
-            return;
-        }
-
         // ───────────────────────────────────────────────
         // incomplete → use FIXED accumulator
         // ───────────────────────────────────────────────
@@ -232,7 +488,7 @@ export function createAccumulators(ctx: {
         const h = p.headers;
         if (p.routePipe!.ct!.type !== h["content-type"]) {
             socket.write(errorRespMap.RESP_400);
-            socket.destroy();
+            socket.destroySoon();
             return;
         }
 
@@ -244,7 +500,7 @@ export function createAccumulators(ctx: {
 
         if (p.routePipe!.ct!.encoding !== h["content-encoding"]) {
             socket.write(errorRespMap.RESP_400);
-            socket.destroy();
+            socket.destroySoon();
             return;
         }
 
@@ -256,13 +512,13 @@ export function createAccumulators(ctx: {
 
         if (p.routePipe!.ct!.type !== h["content-type"]) {
             socket.write(errorRespMap.RESP_400);
-            socket.destroy();
+            socket.destroySoon();
             return;
         }
 
         if (p.routePipe!.ct!.encoding !== h["content-encoding"]) {
             socket.write(errorRespMap.RESP_400);
-            socket.destroy();
+            socket.destroySoon();
             return;
         }
 
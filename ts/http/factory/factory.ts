@@ -113,6 +113,8 @@ function createEndpoint(
         maxContentSize: cfg?.maxContentSize,
         maxHeaderSize: cfg?.maxHeaderSize,
         untilEnd: cfg?.untilEnd,
+        staticHeaders: cfg?.headers,
+        stream: cfg?.stream,
         accumulateHandle,
         addMiddleware(mw) {
             (this as Http.Endpoint).middlewares.push(mw);
@@ -26,10 +26,13 @@ function createPipeline(
     const { inlineCode } = createMwsInline(pipeFns);
     const PipelineCtor = hasAsync ? AsyncFunction : Function;
 
+    // query is a getter so the deferred query string is only decoded when a
+    // handler reads it.
     const setRequestObj = `const req = {
     headers: p.headers,
     params: p.params,
-    query: p.query,
+    get query() { return p.query; },
+    set query(v) { p.query = v; },
     url: ""`;
 
 
@@ -43,11 +46,13 @@ function createPipeline(
             };
 
             const res = p.allocateResp();
+            // Pool exhausted, answered with 503 by the accumulator.
+            if (res === null) return cb(null, null);
+            res.setStaticHeaders(p.routePipe.staticHeaders, p.routePipe.staticHeaderNames);
 
             ${inlineCode}
-            ret = res.getResp();
-            res.freeCPool();
-            cb(ret);
+            // res goes back to the pool once the socket has flushed ret.
+            cb(res.getResp(), res);
         `);
 
     }
@@ -62,7 +67,10 @@ function createPipeline(
     let decodeStep = "";
     let bVar = "b";
 
-    if (content?.encoding) {
+    if (ep.stream) {
+        // b is the BodyStream, its slices reach the handler untouched.
+        decodeStep = `/* streamed body */`;
+    } else if (content?.encoding) {
         decodeStep = `
         if (${bVar} != null) {
             ${bVar} = contentDecodingTable["${content.encoding}"](${bVar});
@@ -82,7 +90,9 @@ function createPipeline(
     // PARSING
     let bodyParser = "";
 
-    if (content?.type) {
+    if (ep.stream) {
+        bodyParser = `/* streamed body */`;
+    } else if (content?.type) {
         bodyParser = `
             ${bVar} = contentTypeTable["${content.type}"](${bVar});
         `;
@@ -113,10 +123,10 @@ function createPipeline(
         };
 
         const res = p.allocateResp();
+        if (res === null) return cb(null, null);
+        res.setStaticHeaders(p.routePipe.staticHeaders, p.routePipe.staticHeaderNames);
         ${inlineCode}
-        let ret = res.getResp();
-        res.freeCPool();
-        cb(ret);
+        cb(res.getResp(), res);
     `);
 
 }
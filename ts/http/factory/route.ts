@@ -8,6 +8,7 @@ import { createEndpoint } from "./factory";
 export class RouteBuilder {
     protected accumulators!: ReturnType<typeof createAccumulators>;
     protected routePipes!: Http.RoutePipe[];
+    protected routeStaticHeaders: (Record<string, string> | undefined)[] = [];
     protected _Route!: Http.Route;
 
     constructor(accumulators: ReturnType<typeof createAccumulators>, route: Http.Route) {
@@ -38,6 +39,58 @@ export class RouteBuilder {
         return normalized;
     }
 
+    /**
+     * Param types of a route pattern in path order: `:id(int)` is NUMBER,
+     * any other `:name` is STRING.
+     */
+    static getParamTypes(route: string): Http.RouteParamType[] {
+        const types: Http.RouteParamType[] = [];
+        const re = /:([^\/]*)/g;
+        let m: RegExpExecArray | null;
+
+        while ((m = re.exec(route)) !== null) {
+            types.push(m[1].endsWith("(int)") ? Http.RouteParamType.NUMBER : Http.RouteParamType.STRING);
+        }
+
+        return types;
+    }
+
+    /**
+     * Encodes an endpoint's static response headers and the CORS headers
+     * into the `Name: value\r\n` block copied into every response.
+     */
+    static encodeStaticHeaders(headers: Record<string, string> | undefined, corsHeaders: string): Buffer | null {
+        let block = "";
+
+        if (headers) {
+            for (const k in headers) {
+                const v = String(headers[k]);
+                if (k.toLowerCase() === "content-length") {
+                    throw new Error("Content-Length cannot be a static response header");
+                }
+                if (/[\r\n\0]/.test(k) || /[\r\n\0]/.test(v)) {
+                    throw new Error(`Invalid character in static response header '${k}'`);
+                }
+                block += `${k}: ${v}\r\n`;
+            }
+        }
+
+        if (corsHeaders) block += corsHeaders + "\r\n";
+
+        return block ? Buffer.from(block, "latin1") : null;
+    }
+
+    /**
+     * Lowercase names of the headers in an encoded static block, so a
+     * response can tell when a handler sets one of them again.
+     */
+    static staticHeaderNames(block: Buffer | null): string[] | null {
+        if (block === null) return null;
+        return block.toString("latin1").split("\r\n")
+            .filter(line => line.length !== 0)
+            .map(line => line.slice(0, line.indexOf(":")).trim().toLowerCase());
+    }
+
     static decisionMaker(accumulators: ReturnType<typeof createAccumulators>, ep: Http.Endpoint)  {
         if (ep.method === Http.HttpMethod.GET || ep.method === Http.HttpMethod.HEAD)
             return accumulators.accumulatorHeadGet;
@@ -117,6 +170,7 @@ export class RouteBuilder {
     public buildRoute(state: Http.ServerState) {
         let buildedRoutes: Http.BuildedRoute[] = [];
         let routePipes: Http.RoutePipe[] = [];
+        let routeStaticHeaders: (Record<string, string> | undefined)[] = [];
         let accumulators = this.accumulators;
 
         function buildSubTree(rootRoute: Http.Route, url: string, _mws: Http.Middleware[]) {
@@ -145,11 +199,17 @@ export class RouteBuilder {
                     maxContentSize: ep.maxContentSize || state.maxContentSize,
                     maxHeaderSize: ep.maxHeaderSize || state.maxHeaderNameSize,
                     untilEnd: ep.untilEnd || state.untilEnd,
+                    staticHeaders: null,
+                    staticHeaderNames: null,
+                    stream: !!ep.stream,
                 }) - 1;
-                let bRoute = {
+                RouteBuilder.setStaticHeaders(routePipes[mainIndex], ep.staticHeaders, state.corsHeaders);
+                routeStaticHeaders.push(ep.staticHeaders);
+                let bRoute: Http.BuildedRoute = {
                     method: RouteBuilder.getMethodStr(ep.method),
                     route: RouteBuilder.normalizeRoutePattern(url + ep.url), 
-                    vptrTableIndex: mainIndex 
+                    vptrTableIndex: mainIndex,
+                    paramTypes: RouteBuilder.getParamTypes(url + ep.url)
                 };
                 buildedRoutes.push(bRoute)
             }
@@ -165,10 +225,26 @@ export class RouteBuilder {
         buildSubTree(this._Route, this._Route.url, []);
 
         this.routePipes = routePipes;
+        this.routeStaticHeaders = routeStaticHeaders;
 
         return buildedRoutes
     }
 
+    /**
+     * Re-encodes the static header blocks of the built routes, e.g. after
+     * CORS was enabled on an already built server.
+     */
+    public refreshStaticHeaders(state: Http.ServerState) {
+        for (let i = 0; i < this.routePipes.length; i++) {
+            RouteBuilder.setStaticHeaders(this.routePipes[i], this.routeStaticHeaders[i], state.corsHeaders);
+        }
+    }
+
+    private static setStaticHeaders(pipe: Http.RoutePipe, headers: Record<string, string> | undefined, corsHeaders: string) {
+        pipe.staticHeaders = RouteBuilder.encodeStaticHeaders(headers, corsHeaders);
+        pipe.staticHeaderNames = RouteBuilder.staticHeaderNames(pipe.staticHeaders);
+    }
+
     public setSwagger(conf: Http.SwaggerConfig) {
         const docsUrl = conf.url ?? "/docs";
 
@@ -0,0 +1,43 @@
+/**
+ * Shared, pre-encoded `Date: <IMF-fixdate>\r\n` header line (RFC 9110 §6.6.1).
+ *
+ * A timer re-encodes it once per second into a fresh Buffer, so responses
+ * only copy or reference it and never format a date themselves. Buffers
+ * handed out earlier are never rewritten, a write still queued on a socket
+ * keeps the value it was given.
+ */
+
+/** Length of `Date: Thu, 01 Jan 1970 00:00:00 GMT\r\n`. */
+export const DATE_HEADER_LEN = 37;
+
+type DateListener = (dateHeader: Buffer) => void;
+
+let current = encode();
+const listeners = new Set<DateListener>();
+
+function encode(): Buffer {
+    return Buffer.from(`Date: ${new Date().toUTCString()}\r\n`, "latin1");
+}
+
+function refresh() {
+    current = encode();
+    for (const fn of listeners) fn(current);
+}
+
+// Does not keep the process alive on its own.
+setInterval(refresh, 1000).unref();
+
+/** The current `Date` header line. */
+export function dateHeader(): Buffer {
+    return current;
+}
+
+/**
+ * Calls `fn` now and after every refresh, for responses that embed the
+ * date in a prebuilt buffer. Returns the unsubscribe function.
+ */
+export function onDateHeader(fn: DateListener): () => void {
+    listeners.add(fn);
+    fn(current);
+    return () => listeners.delete(fn);
+}
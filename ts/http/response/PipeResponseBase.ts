@@ -1,4 +1,25 @@
 import { Http } from "../../http";
+import { hypernode } from "../../hypernode";
+import { dateHeader } from "./HttpDate";
+
+const serializeResponse = hypernode.serializeResponse;
+
+/**
+ * Bodies up to this size are copied behind the head by the native
+ * serializer, larger ones are written as their own iovec.
+ */
+const INLINE_BODY_MAX = 1024;
+
+/**
+ * Initial size of a response's output slab, allocated on first use.
+ */
+const OUT_SLAB_INITIAL = 2 * 1024;
+
+/**
+ * A slab that had to grow past this size is dropped on release instead of
+ * being kept by the pooled object.
+ */
+const OUT_SLAB_KEEP_MAX = 64 * 1024;
 
 /**
  * Base HTTP response implementation used internally by the server.
@@ -29,10 +50,36 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
     protected status: number = 200;
 
     /**
-     * Response headers map.
-     * Uses Object.create(null) for maximum performance and safety.
+     * Response header names and values as parallel arrays. Only the first
+     * `headerCount` entries are live; the arrays are cleared by resetting
+     * the count so their backing stores are reused across requests.
+     */
+    protected headerKeys: string[] = [];
+    protected headerValues: string[] = [];
+    protected headerCount: number = 0;
+
+    /**
+     * Pre-encoded static header block of the route (see
+     * `Http.EndpointOpt.headers`), copied into the head as is.
+     */
+    protected staticHeaders: Buffer | null = null;
+
+    /**
+     * Lowercase names of the headers in `staticHeaders`.
+     */
+    protected staticHeaderNames: string[] | null = null;
+
+    /**
+     * Set when a dynamic header replaces one of the static block, which is
+     * then serialized without it (see `getStaticHeaders`).
      */
-    protected headers: Record<string, string> = Object.create(null);
+    protected staticOverridden: boolean = false;
+
+    /**
+     * Output slab the serialized response is written into, reused across
+     * requests. Owned until the socket has flushed it (see `freeCPool`).
+     */
+    protected out: Buffer | null = null;
 
     /**
      * Marks whether response has been finalized (send/json/redirect called).
@@ -68,6 +115,13 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
             configurable: false,
             enumerable: false
         });
+        // Passed as the socket write callback, see freeCPool.
+        Object.defineProperty(this, "freeCPool", {
+            value: this.freeCPool.bind(this),
+            writable: false,
+            configurable: false,
+            enumerable: false
+        });
     }
 
     /* ===================== */
@@ -84,13 +138,21 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
 
     /**
      * Resets state and returns object back to the pool.
+     *
+     * The buffers returned by `getResp` point into this object's output
+     * slab, so this runs as the write callback of the response, once the
+     * socket no longer needs them.
      */
     public freeCPool() {
         this.body = "";
         this.status = 200;
-        this.headers = Object.create(null);
+        this.headerCount = 0;
+        this.staticHeaders = null;
+        this.staticHeaderNames = null;
+        this.staticOverridden = false;
         this.finishedFlag = false;
         this.compression = null;
+        if (this.out !== null && this.out.length > OUT_SLAB_KEEP_MAX) this.out = null;
 
         this.cPool.free(this.objId);
     }
@@ -106,7 +168,9 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
 
     /** Returns response headers object. */
     public getHeaders(): Record<string, string> {
-        return this.headers;
+        const headers: Record<string, string> = Object.create(null);
+        for (let i = 0; i < this.headerCount; i++) headers[this.headerKeys[i]] = this.headerValues[i];
+        return headers;
     }
 
     /** Returns response body as string. */
@@ -127,18 +191,48 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
     }
 
     /**
-     * Sets a single response header.
+     * Sets a single response header. A header of the route's static block
+     * with the same name is replaced.
      */
     public setHeader(key: string, value: string): this {
-        this.headers[key] = value;
+        if (this.staticHeaderNames !== null && this.hasStaticHeader(key)) this.staticOverridden = true;
+
+        const keys = this.headerKeys;
+        const n = this.headerCount;
+        for (let i = 0; i < n; i++) {
+            if (keys[i] === key) {
+                this.headerValues[i] = String(value);
+                return this;
+            }
+        }
+        keys[n] = key;
+        this.headerValues[n] = String(value);
+        this.headerCount = n + 1;
         return this;
     }
 
+    /**
+     * Sets the route's pre-encoded static header block and the lowercase
+     * names of its headers (see `RouteBuilder.staticHeaderNames`).
+     */
+    public setStaticHeaders(block: Buffer | null, names: string[] | null = null): this {
+        this.staticHeaders = block;
+        this.staticHeaderNames = names;
+        return this;
+    }
+
+    /**
+     * True when the route's static block carries header `key`.
+     */
+    public hasStaticHeader(key: string): boolean {
+        return this.staticHeaderNames !== null && this.staticHeaderNames.includes(key.toLowerCase());
+    }
+
     /**
      * Merges multiple headers.
      */
     public setHeaders(obj: Record<string, string>): this {
-        for (const k in obj) this.headers[k] = obj[k];
+        for (const k in obj) this.setHeader(k, obj[k]);
         return this;
     }
 
@@ -157,10 +251,11 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
 
     /**
      * Sends JSON response.
-     * Automatically sets Content-Type: application/json.
+     * Sets Content-Type: application/json unless the route's static
+     * headers already carry a Content-Type.
      */
     public json(obj: unknown): void {
-        this.setHeader("Content-Type", "application/json");
+        if (!this.hasStaticHeader("content-type")) this.setHeader("Content-Type", "application/json");
         this.body = JSON.stringify(obj);
         this.finishedFlag = true;
     }
@@ -171,7 +266,7 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
      */
     public redirect(url: string, code: number = 302): void {
         this.status = code | 0;
-        this.headers["Location"] = url;
+        this.setHeader("Location", url);
         this.body = "";
         this.finishedFlag = true;
     }
@@ -182,7 +277,7 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
      */
     public setCompression(enc: "gzip" | "br" | "deflate"): this {
         this.compression = enc;
-        this.headers["Content-Encoding"] = enc;
+        this.setHeader("Content-Encoding", enc);
         return this;
     }
 
@@ -191,7 +286,7 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
     /* ===================== */
 
     /**
-     * Serializes the response into a raw HTTP/1.1 buffer.
+     * Serializes the response for the socket.
      *
      * Includes:
      *  - status line
@@ -199,28 +294,81 @@ export class PipeResponseBase implements Http.IHttpResponseBase {
      *  - optional compression
      *  - content-length
      *
+     * The head is written by the native `serializeResponse` (status line
+     * table, no string building). Small bodies are copied right behind it;
+     * larger ones are returned as a separate buffer so the socket can send
+     * them as the second iovec of one writev instead of copying them.
+     *
      * This is the final step before writing to the socket.
      */
-    public getResp(): Buffer {
-        const hdr = { ...this.headers };
+    public getResp(): Buffer | Buffer[] {
+        if (serializeResponse === undefined) return this.getRespJs();
 
+        let body: Buffer | string = this.body;
+        if (this.compression) {
+            const fn = this.contentEncodingTable[this.compression];
+            if (fn) body = fn(Buffer.from(this.body, "utf-8"));
+        }
+
+        // Large bodies go out as a separate iovec, only their length is serialized.
+        let bodyBuf: Buffer | null = null;
+        if (body.length > INLINE_BODY_MAX) {
+            bodyBuf = typeof body === "string" ? Buffer.from(body, "utf-8") : body;
+        }
+
+        let out = this.out ?? Buffer.allocUnsafeSlow(OUT_SLAB_INITIAL);
+        let n: number;
+        while ((n = serializeResponse(
+            this.status, this.headerKeys, this.headerValues,
+            bodyBuf ? bodyBuf.length : body, out, this.headerCount, this.getStaticHeaders(), dateHeader()
+        )) < 0) {
+            out = Buffer.allocUnsafeSlow(out.length * 2);
+        }
+        this.out = out;
+
+        const head = out.subarray(0, n);
+        return bodyBuf ? [head, bodyBuf] : head;
+    }
+
+    /**
+     * The static block to serialize: as is, or without the lines a dynamic
+     * header replaced. Only the latter re-encodes it.
+     */
+    protected getStaticHeaders(): Buffer | null {
+        if (!this.staticOverridden) return this.staticHeaders;
+
+        const dynamic: string[] = [];
+        for (let i = 0; i < this.headerCount; i++) dynamic.push(this.headerKeys[i].toLowerCase());
+
+        let block = "";
+        for (const line of this.staticHeaders!.toString("latin1").split("\r\n")) {
+            if (line.length === 0) continue;
+            if (!dynamic.includes(line.slice(0, line.indexOf(":")).trim().toLowerCase())) block += line + "\r\n";
+        }
+        return block ? Buffer.from(block, "latin1") : null;
+    }
+
+    /**
+     * Pure JS serializer, used when the addon has no `serializeResponse`.
+     */
+    protected getRespJs(): Buffer | Buffer[] {
         let bodyBuf = Buffer.from(this.body, "utf-8");
 
         if (this.compression) {
             const fn = this.contentEncodingTable[this.compression];
             if (fn) bodyBuf = fn(bodyBuf);
-            hdr["Content-Encoding"] = this.compression;
         }
 
-        hdr["Content-Length"] = Buffer.byteLength(bodyBuf).toString();
-
-        let headerStr = `HTTP/1.1 ${this.status}\r\n`;
-        for (const k in hdr) headerStr += `${k}: ${hdr[k]}\r\n`;
-        headerStr += `\r\n`;
+        let headerStr = `HTTP/1.1 ${this.status}\r\n` + dateHeader().toString("latin1");
+        const staticHeaders = this.getStaticHeaders();
+        if (staticHeaders !== null) headerStr += staticHeaders.toString("latin1");
+        for (let i = 0; i < this.headerCount; i++) {
+            if (this.headerKeys[i].toLowerCase() === "content-length") continue;
+            headerStr += `${this.headerKeys[i]}: ${this.headerValues[i]}\r\n`;
+        }
+        headerStr += `Content-Length: ${bodyBuf.length}\r\n\r\n`;
 
-        return Buffer.concat([
-            Buffer.from(headerStr, "ascii"),
-            bodyBuf
-        ]);
+        const headerBuf = Buffer.from(headerStr, "ascii");
+        return bodyBuf.length === 0 ? headerBuf : [headerBuf, bodyBuf];
     }
 }
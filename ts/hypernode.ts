@@ -2,21 +2,27 @@ import { Http } from "./http";
 import path from "path";
 
 export interface IHttpCore {
-    registerRoutes(routes: Http.BuildedRoute[]): any;
+    registerRoutes(routes: Http.BuildedRoute[], options?: { staticRouteHash?: boolean }): any;
     scannerRouteFirst(
         buffer: Buffer,
         reqObj: Http.ChunkProgression,
         maxHeaderNameSize: number,
         maxHeaderValueSize: number,
         maxContentLength: number,
-        queryLimit: number
+        queryLimit: number,
+        headerSpans?: Uint32Array,
+        resultSlots?: Int32Array,
+        scratch?: Buffer
     ): number;
     scannerHeader(
         buffer: Buffer,
         reqObj: Http.ChunkProgression,
         maxHeaderNameSize: number,
         maxHeaderValueSize: number,
-        maxContentLength: number
+        maxContentLength: number,
+        headerSpans?: Uint32Array,
+        resultSlots?: Int32Array,
+        scratch?: Buffer
     ): void;
     printRouteTree(
         deepth: number
@@ -26,9 +32,31 @@ export interface IHttpCore {
 export interface ICPool {
     initializePool(size: number): void;
     registerObj(obj: object): number;
+    /** Registers every object in one native call, returns their indexes in order. */
+    registerMany?(objs: object[]): Int32Array;
     allocate(): any | null;
     free(index: number): void;
     resizePool(newSize: number): void;
+    /** Active slots that have no registered object. */
+    vacant?(): number;
+    /**
+     * Free stack and in-use flags as an Int32Array, see SharedCPool.
+     * Replaced when the pool grows.
+     */
+    sharedState?(): Int32Array;
+}
+
+/**
+ * Resumable Transfer-Encoding: chunked decoder. `write` compacts chunk data
+ * into `dest` behind what is already there and returns a `ChunkedStatus`;
+ * `consumed` is the number of bytes of the last chunk it used, `length` the
+ * body bytes decoded so far.
+ */
+export interface IChunkedDecoder {
+    reset(maxContentSize: number): void;
+    write(chunk: Buffer, dest: Buffer): number;
+    length(): number;
+    consumed(): number;
 }
 
 export interface IPublicAssetParser {
@@ -46,10 +74,38 @@ export interface HypernodeAddon {
     PublicAssetParser: {
         new (): IPublicAssetParser
     };
+    ChunkedDecoder?: {
+        new (): IChunkedDecoder
+    };
     scanUrl(
         curl: Buffer,
         offset: number
     ): string;
+    parseQuery(
+        buffer: Buffer,
+        start: number,
+        len: number,
+        scratch?: Buffer
+    ): Record<string, string>;
+    /**
+     * Writes status line, headers, Content-Length and (for a Buffer or string
+     * body) the body into outBuf. A number body only sets Content-Length.
+     * Only the first headerCount entries of the header arrays are used when
+     * given; dateHeader and staticHeaders are pre-encoded header lines copied
+     * right after the status line, in that order. Returns the bytes written, or -1 if outBuf is too small.
+     */
+    serializeResponse?(
+        status: number,
+        headerKeys: string[],
+        headerValues: string[],
+        body: Buffer | string | number,
+        outBuf: Buffer,
+        headerCount?: number,
+        staticHeaders?: Buffer | null,
+        dateHeader?: Buffer
+    ): number;
+    /** Heap allocations made on the JS thread, only in alloc_stats builds. */
+    allocCount?(): number;
 }
 
 export const hypernode = require('node-gyp-build')(path.join(__dirname, '..')) as HypernodeAddon;
\ No newline at end of file
@@ -30,6 +30,7 @@ export { createServer };
 // ================================
 export * from "./http";
 export * from "./http/response/PipeResponseBase";
+export { BodyStream } from "./http/chunker/BodyStream";
 
 // ================================
 // Factories / Builders